@@ -0,0 +1,342 @@
+#include <tonc.h>
+#include <cstdio>
+
+// BENCHMARK:
+// This example runs on a PC (see `lib/host`). It simulates 2-4 GBAs connected
+// with a Link Cable and measures the throughput of different configurations.
+// Every console sends consecutive values and checks that it receives
+// previousValue + 1 from each remote player (like in LinkCable_stress).
+// The same test is repeated with a RELIABLE `LinkCableT<Config>`, with
+// ADAPTIVE_INTERVAL (where `int` is only the initial interval) and with BURST.
+// Then, it sends large packets with LinkCableStream and checks their content
+// (also with a bigger QUEUE_SIZE, which raises its per-frame cap).
+// Finally, it measures the cost of each interrupt handler with LinkProfiler.
+
+#include "../../../lib/LinkCable.h"
+#include "../../../lib/LinkCableStream.h"
+#include "../../../lib/LinkProfiler.h"
+
+#define WARMUP_FRAMES 30
+#define FRAMES 600
+#define MAX_WORDS_PER_FRAME 32
+#define STREAM_PACKET_SIZE 4096
+
+struct Scenario {
+  LinkCable::BaudRate baudRate;
+  u16 interval;
+  u32 players;
+  u32 wordsPerFrame;
+};
+
+const Scenario SCENARIOS[] = {
+    {LinkCable::BaudRate::BAUD_RATE_1, 50, 2, 4},
+    {LinkCable::BaudRate::BAUD_RATE_1, 50, 4, 4},
+    {LinkCable::BaudRate::BAUD_RATE_3, 50, 2, 4},
+    {LinkCable::BaudRate::BAUD_RATE_3, 50, 4, 4},
+    {LinkCable::BaudRate::BAUD_RATE_3, 25, 4, 8},
+    {LinkCable::BaudRate::BAUD_RATE_3, 10, 4, 12},
+    {LinkCable::BaudRate::BAUD_RATE_3, 10, 4, 24},
+};
+const u32 BAUD_RATES[] = {9600, 38400, 57600, 115200};
+const u16 STREAM_INTERVALS[] = {50, 25, 10, 6, 5};
+const Scenario PROFILE_SCENARIO = {LinkCable::BaudRate::BAUD_RATE_3, 10, 4, 24};
+const LinkProfiler::Handler PROFILE_HANDLERS[] = {
+    LinkProfiler::Handler::CABLE_VBLANK, LinkProfiler::Handler::CABLE_SERIAL,
+    LinkProfiler::Handler::CABLE_TIMER};
+const char* PROFILE_HANDLER_NAMES[] = {"VBLANK", "SERIAL", "TIMER"};
+
+struct ReliableConfig : LinkCableDefaultConfig {
+  static constexpr bool RELIABLE = true;
+};
+using ReliableLinkCable = LinkCableT<ReliableConfig>;
+
+struct AdaptiveConfig : LinkCableDefaultConfig {
+  static constexpr bool ADAPTIVE_INTERVAL = true;
+};
+using AdaptiveLinkCable = LinkCableT<AdaptiveConfig>;
+
+struct BurstConfig : LinkCableDefaultConfig {
+  static constexpr bool BURST = true;
+};
+using BurstLinkCable = LinkCableT<BurstConfig>;
+
+struct BigQueueConfig : LinkCableDefaultConfig {
+  static constexpr u32 QUEUE_SIZE = 128;
+};
+using BigQueueLinkCable = LinkCableT<BigQueueConfig>;
+
+LinkHostBus* linkHostBus = NULL;
+LinkCable* linkCable = NULL;
+template <typename Cable>
+Cable* linkCables[LINK_HOST_MAX_CONSOLES];
+template <typename Cable>
+Cable* currentLinkCable = NULL;
+template <typename Cable>
+LinkCableStreamT<Cable>* linkCableStreams[LINK_HOST_MAX_CONSOLES];
+LinkProfiler* linkProfiler = NULL;
+LinkProfiler* linkProfilers[LINK_HOST_MAX_CONSOLES];
+
+struct Counters {
+  u16 localCounter;
+  u16 remoteCounters[LINK_CABLE_MAX_PLAYERS];
+  u32 received;
+  u32 errors;
+};
+
+Counters counters[LINK_HOST_MAX_CONSOLES];
+
+struct StreamCounters {
+  u8 outgoing[STREAM_PACKET_SIZE];
+  u8 incoming[STREAM_PACKET_SIZE];
+  u32 sentPackets;
+  u32 receivedPackets;
+  u32 failedPackets;
+  u32 errors;
+};
+
+StreamCounters streamCounters[2];
+
+template <typename Cable>
+void setUp(u32 players, LinkCable::BaudRate baudRate, u16 interval) {
+  linkHostBus = new LinkHostBus(players);
+  for (u32 i = 0; i < players; i++) {
+    linkCables<Cable>[i] =
+        new Cable((typename Cable::BaudRate)baudRate,
+                  LINK_CABLE_DEFAULT_TIMEOUT,
+                  LINK_CABLE_DEFAULT_REMOTE_TIMEOUT, interval);
+  }
+  linkHostBus->setContextHandler([](u32 id) {
+    currentLinkCable<Cable> = linkCables<Cable>[id];
+    linkProfiler = linkProfilers[id];
+  });
+
+  for (u32 i = 0; i < players; i++) {
+    linkHostBus->runOn(i, []() {
+      irq_init(NULL);
+      irq_add(II_VBLANK, []() {
+        linkProfiler->profile(LinkProfiler::Handler::CABLE_VBLANK,
+                              []() { currentLinkCable<Cable>->_onVBlank(); });
+      });
+      irq_add(II_SERIAL, []() {
+        linkProfiler->profile(LinkProfiler::Handler::CABLE_SERIAL,
+                              []() { currentLinkCable<Cable>->_onSerial(); });
+      });
+      irq_add(II_TIMER3, []() {
+        linkProfiler->profile(LinkProfiler::Handler::CABLE_TIMER,
+                              []() { currentLinkCable<Cable>->_onTimer(); });
+      });
+      currentLinkCable<Cable>->activate();
+    });
+  }
+
+  linkHostBus->runFrames(WARMUP_FRAMES,
+                         [](u32 id) { linkCables<Cable>[id]->consume(); });
+  linkHostBus->resetStats();
+}
+
+template <typename Cable>
+void tearDown(u32 players) {
+  for (u32 i = 0; i < players; i++) {
+    linkHostBus->runOn(i, []() { linkProfiler->deactivate(); });
+    delete linkCables<Cable>[i];
+  }
+  delete linkHostBus;
+  linkHostBus = NULL;
+}
+
+void printProfile(u32 players) {
+  printf("handler |  count |  min |  avg |  max | histogram (2^i cycles)\n");
+
+  for (u32 h = 0; h < 3; h++) {
+    LinkProfiler::Stats total;
+    for (u32 i = 0; i < players; i++) {
+      auto stats = linkProfilers[i]->getStats(PROFILE_HANDLERS[h]);
+      if (stats.count == 0)
+        continue;
+      if (total.count == 0 || stats.min < total.min)
+        total.min = stats.min;
+      if (stats.max > total.max)
+        total.max = stats.max;
+      total.count += stats.count;
+      total.total += stats.total;
+      for (u32 j = 0; j < LINK_PROFILER_HISTOGRAM_BUCKETS; j++)
+        total.histogram[j] += stats.histogram[j];
+    }
+    if (total.count > 0)
+      total.avg = total.total / total.count;
+
+    printf("%7s | %6d | %4d | %4d | %4d |", PROFILE_HANDLER_NAMES[h],
+           total.count, total.min, total.avg, total.max);
+    for (u32 j = 0; j < LINK_PROFILER_HISTOGRAM_BUCKETS; j++) {
+      if (total.histogram[j] > 0)
+        printf(" %d:%d", j, total.histogram[j]);
+    }
+    printf("\n");
+  }
+}
+
+template <typename Cable>
+void run(const Scenario& scenario, bool profile = false) {
+  for (u32 i = 0; i < scenario.players; i++)
+    counters[i] = Counters{};
+  setUp<Cable>(scenario.players, scenario.baudRate, scenario.interval);
+  if (profile) {
+    for (u32 i = 0; i < scenario.players; i++)
+      linkHostBus->runOn(i, []() { linkProfiler->activate(); });
+  }
+
+  linkHostBus->runFrames(FRAMES, [&scenario](u32 id) {
+    Counters& c = counters[id];
+    Cable* linkCable = linkCables<Cable>[id];
+
+    if (linkCable->playerCount() == scenario.players) {
+      u16 words[MAX_WORDS_PER_FRAME];
+      for (u32 i = 0; i < scenario.wordsPerFrame; i++)
+        words[i] = ((c.localCounter + i) % 0xfffe) + 1;
+      c.localCounter += linkCable->send(words, scenario.wordsPerFrame);
+    }
+
+    for (u32 i = 0; i < scenario.players; i++) {
+      u16 messages[LINK_CABLE_QUEUE_SIZE];
+      u32 count = linkCable->readAll(i, messages, LINK_CABLE_QUEUE_SIZE);
+      for (u32 j = 0; j < count; j++) {
+        u16 message = messages[j] - 1;
+        if (message != c.remoteCounters[i] % 0xfffe)
+          c.errors++;
+        c.remoteCounters[i] = message + 1;
+        c.received++;
+      }
+    }
+
+    linkCable->consume();
+  });
+
+  u32 sent = 0, received = 0, errors = 0;
+  u64 irqCycles = 0;
+  for (u32 i = 0; i < scenario.players; i++) {
+    sent += counters[i].localCounter;
+    received += counters[i].received;
+    errors += counters[i].errors;
+    irqCycles += linkHostBus->getStats(i).irqCycles;
+  }
+  u32 expected = sent * (scenario.players - 1);
+
+  printf("%6d | %3d | %d | %2d | %7.2f | %6.2f%% | %5d | %8.0f\n",
+         BAUD_RATES[scenario.baudRate], scenario.interval, scenario.players,
+         scenario.wordsPerFrame, (float)received / FRAMES / scenario.players,
+         expected > 0 ? 100.0f * received / expected : 0.0f, errors,
+         (float)irqCycles / FRAMES / scenario.players);
+
+  if (profile)
+    printProfile(scenario.players);
+
+  tearDown<Cable>(scenario.players);
+}
+
+template <typename Cable>
+void runStream(u16 interval) {
+  setUp<Cable>(2, LinkCable::BaudRate::BAUD_RATE_3, interval);
+  for (u32 i = 0; i < 2; i++) {
+    StreamCounters& c = streamCounters[i];
+    c = StreamCounters{};
+    for (u32 j = 0; j < STREAM_PACKET_SIZE; j++)
+      c.outgoing[j] = (u8)(j * 7 + i);
+    linkCableStreams<Cable>[i] =
+        new LinkCableStreamT<Cable>(linkCables<Cable>[i]);
+    linkCableStreams<Cable>[i]->setReceiveBuffer(!i, c.incoming,
+                                                 STREAM_PACKET_SIZE);
+  }
+
+  linkHostBus->runFrames(FRAMES, [](u32 id) {
+    StreamCounters& c = streamCounters[id];
+    auto linkCableStream = linkCableStreams<Cable>[id];
+
+    if (!linkCableStream->isSending() &&
+        linkCableStream->send(c.outgoing, STREAM_PACKET_SIZE))
+      c.sentPackets++;
+
+    linkCableStream->update();
+
+    auto state = linkCableStream->getState(!id);
+    if (state == LinkCableStreamT<Cable>::COMPLETED) {
+      for (u32 i = 0; i < STREAM_PACKET_SIZE; i++) {
+        if (c.incoming[i] != (u8)(i * 7 + !id)) {
+          c.errors++;
+          break;
+        }
+      }
+      c.receivedPackets++;
+    } else if (state == LinkCableStreamT<Cable>::FAILED)
+      c.failedPackets++;
+    if (state == LinkCableStreamT<Cable>::COMPLETED ||
+        state == LinkCableStreamT<Cable>::FAILED)
+      linkCableStream->setReceiveBuffer(!id, c.incoming, STREAM_PACKET_SIZE);
+
+    linkCables<Cable>[id]->consume();
+  });
+
+  u32 received = 0, failed = 0, errors = 0, receivedBytes = 0;
+  for (u32 i = 0; i < 2; i++) {
+    received += streamCounters[i].receivedPackets;
+    failed += streamCounters[i].failedPackets;
+    errors += streamCounters[i].errors;
+    receivedBytes += streamCounters[i].receivedPackets * STREAM_PACKET_SIZE +
+                     linkCableStreams<Cable>[i]->receivedBytes(!i);
+    delete linkCableStreams<Cable>[i];
+  }
+
+  printf("115200 | %3d | %5d | %6d | %5d | %9.2f\n", interval, received,
+         failed, errors, (float)receivedBytes / FRAMES / 2);
+
+  tearDown<Cable>(2);
+}
+
+int main() {
+  for (u32 i = 0; i < LINK_HOST_MAX_CONSOLES; i++)
+    linkProfilers[i] = new LinkProfiler();
+
+  printf("  baud | int | P | tx |  rx/frm |     rx%% |  errs | irqcy/frm\n");
+
+  for (auto& scenario : SCENARIOS)
+    run<LinkCable>(scenario);
+
+  printf("\nLinkCable (RELIABLE mode):\n");
+  printf("  baud | int | P | tx |  rx/frm |     rx%% |  errs | irqcy/frm\n");
+
+  for (auto& scenario : SCENARIOS)
+    run<ReliableLinkCable>(scenario);
+
+  printf("\nLinkCable (ADAPTIVE_INTERVAL mode):\n");
+  printf("  baud | int | P | tx |  rx/frm |     rx%% |  errs | irqcy/frm\n");
+
+  for (auto& scenario : SCENARIOS)
+    run<AdaptiveLinkCable>(scenario);
+
+  printf("\nLinkCable (BURST mode):\n");
+  printf("  baud | int | P | tx |  rx/frm |     rx%% |  errs | irqcy/frm\n");
+
+  for (auto& scenario : SCENARIOS)
+    run<BurstLinkCable>(scenario);
+
+  printf("\nLinkCableStream (2 players, %d-byte packets):\n",
+         STREAM_PACKET_SIZE);
+  printf("  baud | int | recvd | failed |  errs | bytes/frm\n");
+
+  for (auto interval : STREAM_INTERVALS)
+    runStream<LinkCable>(interval);
+
+  printf("\nLinkCableStream (QUEUE_SIZE = %d):\n", BigQueueConfig::QUEUE_SIZE);
+  printf("  baud | int | recvd | failed |  errs | bytes/frm\n");
+
+  for (auto interval : STREAM_INTERVALS)
+    runStream<BigQueueLinkCable>(interval);
+
+  printf("\nLinkProfiler (cycles per handler, I/O cost only):\n");
+  printf("  baud | int | P | tx |  rx/frm |     rx%% |  errs | irqcy/frm\n");
+  run<LinkCable>(PROFILE_SCENARIO, true);
+  printf("\nLinkProfiler (RELIABLE mode):\n");
+  printf("  baud | int | P | tx |  rx/frm |     rx%% |  errs | irqcy/frm\n");
+  run<ReliableLinkCable>(PROFILE_SCENARIO, true);
+
+  return 0;
+}
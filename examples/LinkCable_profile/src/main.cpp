@@ -0,0 +1,112 @@
+#include <tonc.h>
+#include <string>
+#include "../../_lib/interrupt.h"
+
+// PROFILE:
+// This example measures how many cycles LinkCable's interrupt handlers take.
+// Build it twice to compare ROM (Thumb) and IWRAM (ARM) placement:
+//   make rebuild           (default)
+//   make rebuild IWRAM=1   (-DLINK_CABLE_PUT_ISR_IN_IWRAM=1)
+// Hold A to send a message every frame, or B to fill the outgoing queue.
+
+// (the Makefile defines LINK_CABLE_ENABLE_PROFILER=1)
+#include "../../../lib/LinkCable.h"
+#include "../../../lib/LinkProfiler.h"
+
+void log(std::string text);
+u16 nextValue(u16& counter);
+std::string printStats(std::string name, LinkProfiler::Handler handler);
+
+LinkCable* linkCable = new LinkCable();
+LinkProfiler* linkProfiler = new LinkProfiler();
+
+void init() {
+  REG_DISPCNT = DCNT_MODE0 | DCNT_BG0;
+  tte_init_se_default(0, BG_CBB(0) | BG_SBB(31));
+
+  interrupt_init();
+  interrupt_set_handler(INTR_VBLANK, LINK_CABLE_ISR_VBLANK);
+  interrupt_enable(INTR_VBLANK);
+  interrupt_set_handler(INTR_SERIAL, LINK_CABLE_ISR_SERIAL);
+  interrupt_enable(INTR_SERIAL);
+  interrupt_set_handler(INTR_TIMER3, LINK_CABLE_ISR_TIMER);
+  interrupt_enable(INTR_TIMER3);
+
+  // (timers 0 and 1 are used by the profiler, and 3 by LinkCable)
+  linkProfiler->activate();
+  linkCable->activate();
+}
+
+int main() {
+  init();
+
+  u16 counter = 0;
+  u32 received = 0;
+
+  while (true) {
+    u16 keys = ~REG_KEYS & KEY_ANY;
+
+    if (keys & KEY_A)
+      linkCable->send(nextValue(counter));
+    if (keys & KEY_B) {
+      for (u32 i = 0; i < LINK_CABLE_QUEUE_SIZE; i++)
+        linkCable->send(nextValue(counter));
+    }
+    if (keys & KEY_SELECT)
+      linkProfiler->reset();
+
+    std::string output = "";
+#if LINK_CABLE_PUT_ISR_IN_IWRAM
+    output += "ISRs: IWRAM (ARM)\n";
+#else
+    output += "ISRs: ROM (Thumb)\n";
+#endif
+
+    if (linkCable->isConnected()) {
+      u8 playerCount = linkCable->playerCount();
+      for (u32 i = 0; i < playerCount; i++) {
+        while (linkCable->canRead(i)) {
+          linkCable->read(i);
+          received++;
+        }
+      }
+
+      output += "Players: " + std::to_string(playerCount) + "\n";
+      output += "Received: " + std::to_string(received) + "\n";
+    } else {
+      output += "Waiting...\n";
+    }
+
+    output += "\n(cycles: count min/avg/max)\n";
+    output += printStats("VBLANK", LinkProfiler::Handler::CABLE_VBLANK);
+    output += printStats("SERIAL", LinkProfiler::Handler::CABLE_SERIAL);
+    output += printStats("TIMER", LinkProfiler::Handler::CABLE_TIMER);
+    output += "\n(A: send, B: burst, SELECT: reset)";
+
+    linkCable->consume();
+
+    VBlankIntrWait();
+    log(output);
+  }
+
+  return 0;
+}
+
+u16 nextValue(u16& counter) {
+  counter = counter % (LINK_CABLE_DISCONNECTED - 1) + 1;
+  return counter;  // (avoid using 0 and 0xFFFF)
+}
+
+std::string printStats(std::string name, LinkProfiler::Handler handler) {
+  auto stats = linkProfiler->getStats(handler);
+
+  return name + ": " + std::to_string(stats.count) + "\n  " +
+         std::to_string(stats.min) + "/" + std::to_string(stats.avg) + "/" +
+         std::to_string(stats.max) + "\n";
+}
+
+void log(std::string text) {
+  tte_erase_screen();
+  tte_write("#{P:0,0}");
+  tte_write(text.c_str());
+}
@@ -0,0 +1,106 @@
+#include <tonc.h>
+#include <string>
+#include "../../_lib/interrupt.h"
+
+// CRC:
+// This example measures how many cycles LinkWireless' transfer CRC takes, for
+// the largest client and server transfers. It doesn't need a Wireless Adapter.
+// Build it twice to compare ROM (Thumb) and IWRAM (ARM) placement:
+//   make rebuild           (default)
+//   make rebuild IWRAM=1   (-DLINK_WIRELESS_PUT_ISR_IN_IWRAM=1)
+// Hold A to measure 16 transfers per frame instead of 1.
+
+// (the Makefile defines LINK_WIRELESS_USE_TRANSFER_CRC=1)
+#include "../../../lib/LinkProfiler.h"
+#include "../../../lib/LinkWireless.h"
+
+// (the CRC word counts as transfer length, so it's not part of the data)
+#define CLIENT_WORDS (LINK_WIRELESS_MAX_CLIENT_TRANSFER_LENGTH - 1)
+#define SERVER_WORDS (LINK_WIRELESS_MAX_SERVER_TRANSFER_LENGTH - 1)
+
+inline void VBLANK() {}
+void log(std::string text);
+void fillTransfer(u32* data, u32 size);
+std::string printStats(std::string name, LinkProfiler::Handler handler);
+
+LinkProfiler* linkProfiler = new LinkProfiler();
+volatile u32 lastCRC = 0;
+
+void init() {
+  REG_DISPCNT = DCNT_MODE0 | DCNT_BG0;
+  tte_init_se_default(0, BG_CBB(0) | BG_SBB(31));
+
+  interrupt_init();
+  interrupt_set_handler(INTR_VBLANK, VBLANK);
+  interrupt_enable(INTR_VBLANK);
+
+  // (timers 0 and 1 are used by the profiler)
+  linkProfiler->activate();
+}
+
+int main() {
+  init();
+
+  u32 clientTransfer[CLIENT_WORDS];
+  u32 serverTransfer[SERVER_WORDS];
+
+  while (true) {
+    u16 keys = ~REG_KEYS & KEY_ANY;
+    u32 repetitions = keys & KEY_A ? 16 : 1;
+
+    if (keys & KEY_SELECT)
+      linkProfiler->reset();
+
+    for (u32 i = 0; i < repetitions; i++) {
+      fillTransfer(clientTransfer, CLIENT_WORDS);
+      linkProfiler->profile(LinkProfiler::Handler::CUSTOM_0, [&]() {
+        lastCRC = LinkWireless::_buildTransferCRC(clientTransfer, CLIENT_WORDS);
+      });
+
+      fillTransfer(serverTransfer, SERVER_WORDS);
+      linkProfiler->profile(LinkProfiler::Handler::CUSTOM_1, [&]() {
+        lastCRC = LinkWireless::_buildTransferCRC(serverTransfer, SERVER_WORDS);
+      });
+    }
+
+    std::string output = "";
+#if LINK_WIRELESS_PUT_ISR_IN_IWRAM
+    output += "CRC: IWRAM (ARM)\n";
+#else
+    output += "CRC: ROM (Thumb)\n";
+#endif
+
+    output += "\n(cycles: count min/avg/max)\n";
+    output += printStats("CLIENT (" + std::to_string(CLIENT_WORDS) + " words)",
+                         LinkProfiler::Handler::CUSTOM_0);
+    output += printStats("SERVER (" + std::to_string(SERVER_WORDS) + " words)",
+                         LinkProfiler::Handler::CUSTOM_1);
+    output += "\nLast CRC: " + std::to_string(lastCRC & 0xffff) + "\n";
+    output += "\n(A: x16, SELECT: reset)";
+
+    VBlankIntrWait();
+    log(output);
+  }
+
+  return 0;
+}
+
+void fillTransfer(u32* data, u32 size) {
+  // (a different payload every time, so the compiler can't skip the work)
+  for (u32 i = 0; i < size; i++)
+    data[i] = (qran() << 16) | qran();
+}
+
+std::string printStats(std::string name, LinkProfiler::Handler handler) {
+  auto stats = linkProfiler->getStats(handler);
+
+  return name + ": " + std::to_string(stats.count) + "\n  " +
+         std::to_string(stats.min) + "/" + std::to_string(stats.avg) + "/" +
+         std::to_string(stats.max) + "\n";
+}
+
+void log(std::string text) {
+  tte_erase_screen();
+  tte_write("#{P:0,0}");
+  tte_write(text.c_str());
+}
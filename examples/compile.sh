@@ -15,6 +15,13 @@ make rebuild
 cp LinkCable_stress.gba ../
 cd ..
 
+cd LinkCable_profile/
+make rebuild
+cp LinkCable_profile.gba ../
+make rebuild IWRAM=1
+cp LinkCable_profile.gba ../LinkCable_profile_iwram.gba
+cd ..
+
 cd LinkCableMultiboot_demo/
 make rebuild
 cp LinkCableMultiboot_demo.mb.gba ../
@@ -46,3 +53,10 @@ cd LinkWireless_demo/
 make rebuild
 cp LinkWireless_demo.gba ../
 cd ..
+
+cd LinkWireless_crc/
+make rebuild
+cp LinkWireless_crc.gba ../
+make rebuild IWRAM=1
+cp LinkWireless_crc.gba ../LinkWireless_crc_iwram.gba
+cd ..
@@ -12,6 +12,11 @@
 //       irq_add(II_VBLANK, LINK_CABLE_ISR_VBLANK);
 //       irq_add(II_SERIAL, LINK_CABLE_ISR_SERIAL);
 //       irq_add(II_TIMER3, LINK_CABLE_ISR_TIMER);
+// - 2b) Or, to avoid the global pointer, use a static instance:
+//       LinkCable myLinkCable;
+//       irq_add(II_VBLANK, LinkCable::ISR<myLinkCable>::VBLANK);
+//       irq_add(II_SERIAL, LinkCable::ISR<myLinkCable>::SERIAL);
+//       irq_add(II_TIMER3, LinkCable::ISR<myLinkCable>::TIMER);
 // - 3) Initialize the library with:
 //       linkCable->activate();
 // - 4) Send/read messages by using:
@@ -23,9 +28,15 @@
 //         u16 message = linkCable->read(!currentPlayerId);
 //         // ...
 //       }
+// - 4b) Or send/read multiple messages at once:
+//       u32 sentCount = linkCable->send(words, wordCount);
+//       u32 readCount = linkCable->readAll(!currentPlayerId, buffer, max);
 // - 5) Mark the current state copy (front buffer) as consumed:
 //       linkCable->consume();
 //       // (put this line at the end of your game loop)
+// - 6) (Optional) Read the statistics counters:
+//       LinkCable::Stats stats = linkCable->getStats();
+//       // (requires LINK_CABLE_ENABLE_STATS)
 // --------------------------------------------------------------------------
 // (*) libtonc's interrupt handler sometimes ignores interrupts due to a bug.
 //     That can cause packet loss. You might want to use libugba's instead.
@@ -34,12 +45,55 @@
 // `send(...)` restrictions:
 // - 0xFFFF and 0x0 are reserved values, so don't send them!
 //   (they mean 'disconnected' and 'no data' respectively)
+//   (or enable ESCAPE_RESERVED_VALUES in a custom `LinkCableT<Config>`)
+// - messages can get lost on connection resets or missed IRQs
+//   (or enable RELIABLE in a custom `LinkCableT<Config>`)
+// - when the outgoing queue is full, it returns `false` and drops the message
 // --------------------------------------------------------------------------
 
 #include <tonc_core.h>
-
-// Buffer size
-#define LINK_CABLE_QUEUE_SIZE 30
+#include <algorithm>
+
+// Statistics counters (0 = disabled, 1 = enabled)
+#ifndef LINK_CABLE_ENABLE_STATS
+#define LINK_CABLE_ENABLE_STATS 0
+#endif
+
+#if LINK_CABLE_ENABLE_STATS
+#define LINK_CABLE_STATS(...) __VA_ARGS__
+#else
+#define LINK_CABLE_STATS(...)
+#endif
+
+// ISR profiling in LINK_CABLE_ISR_* (0 = disabled, 1 = enabled)
+#ifndef LINK_CABLE_ENABLE_PROFILER
+#define LINK_CABLE_ENABLE_PROFILER 0
+#endif
+
+#if LINK_CABLE_ENABLE_PROFILER
+#include "LinkProfiler.h"
+#define LINK_CABLE_PROFILE(HANDLER, CALL) \
+  linkProfiler->profile(LinkProfiler::Handler::HANDLER, []() { CALL; })
+#else
+#define LINK_CABLE_PROFILE(HANDLER, CALL) CALL
+#endif
+
+// ISRs and hot paths in IWRAM as ARM code (0 = disabled, 1 = enabled)
+// (it must be defined for all files, e.g. with -DLINK_CABLE_PUT_ISR_IN_IWRAM=1,
+//  since the LINK_CABLE_ISR_* functions are compiled in LinkCable.iwram.cpp)
+#ifndef LINK_CABLE_PUT_ISR_IN_IWRAM
+#define LINK_CABLE_PUT_ISR_IN_IWRAM 0
+#endif
+
+#if LINK_CABLE_PUT_ISR_IN_IWRAM
+#define LINK_CABLE_IWRAM_CODE \
+  __attribute__((section(".iwram.link_cable"), target("arm"), long_call))
+#else
+#define LINK_CABLE_IWRAM_CODE
+#endif
+
+// Buffer size (must be a power of two)
+#define LINK_CABLE_QUEUE_SIZE 32
 
 #define LINK_CABLE_MAX_PLAYERS 4
 #define LINK_CABLE_DISCONNECTED 0xFFFF
@@ -62,6 +116,30 @@
 #define LINK_CABLE_SET_HIGH(REG, BIT) REG |= 1 << BIT
 #define LINK_CABLE_SET_LOW(REG, BIT) REG &= ~(1 << BIT)
 #define LINK_CABLE_BARRIER asm volatile("" ::: "memory")
+#define LINK_CABLE_DYNAMIC (-1)
+#define LINK_CABLE_ESCAPE 0xFFFE
+#define LINK_CABLE_ESCAPED_NO_DATA 1
+#define LINK_CABLE_ESCAPED_DISCONNECTED 2
+#define LINK_CABLE_ESCAPED_ESCAPE 3
+#define LINK_CABLE_RELIABLE_WINDOW_SIZE 128
+#define LINK_CABLE_RELIABLE_MARK_INTERVAL 16
+#define LINK_CABLE_RELIABLE_RETRANSMIT_TIMEOUT 64
+#define LINK_CABLE_RELIABLE_SEQUENCE_MASK 0xfff
+#define LINK_CABLE_RELIABLE_CONTROL_MASK 0xf000
+#define LINK_CABLE_RELIABLE_CONTROL_MARK 0x4000
+#define LINK_CABLE_RELIABLE_CONTROL_MARK_BASE 0x5000
+#define LINK_CABLE_RELIABLE_CONTROL_HELLO 0x6000
+#define LINK_CABLE_RELIABLE_CONTROL_SESSION 0x7000
+#define LINK_CABLE_RELIABLE_CONTROL_ACK 0x8000
+#define LINK_CABLE_RELIABLE_CONTROL_RESYNC 0xc000
+#define LINK_CABLE_RELIABLE_BITS_PLAYER_ID 12
+#define LINK_CABLE_RELIABLE_NO_SESSION 0x10000
+#define LINK_CABLE_RELIABLE_CHECKSUM_SEED 0x1d0f
+#define LINK_CABLE_TOTAL_LINES 228
+#define LINK_CABLE_ADAPTIVE_MAX_INTERVAL 200
+#define LINK_CABLE_ADAPTIVE_MARGIN 2
+#define LINK_CABLE_BURST_MAX_TRANSFERS 32
+#define LINK_CABLE_BURST_GAP 2
 
 static volatile char LINK_CABLE_VERSION[] = "LinkCable/v5.0.2";
 
@@ -71,8 +149,56 @@ void LINK_CABLE_ISR_TIMER();
 const u16 LINK_CABLE_TIMER_IRQ_IDS[] = {IRQ_TIMER0, IRQ_TIMER1, IRQ_TIMER2,
                                         IRQ_TIMER3};
 
-class LinkCable {
+// Compile-time configuration (see `LinkCableT<Config>`)
+// - MAX_PLAYERS: number of players that the game supports (2-4)
+// - QUEUE_SIZE: size of each queue (must be a power of two)
+// - BAUD_RATE: a `LinkCable::BaudRate` value, or LINK_CABLE_DYNAMIC
+// - SEND_TIMER_ID: a timer id (0-3), or LINK_CABLE_DYNAMIC
+// - ESCAPE_RESERVED_VALUES: allows sending any u16, by replacing 0x0, 0xFFFF
+//   and 0xFFFE with two-word escape sequences (all players must enable it)
+// - RELIABLE: adds sequence numbers, acks and retransmissions, so messages
+//   are never lost or duplicated (implies ESCAPE_RESERVED_VALUES)
+// - ADAPTIVE_INTERVAL: makes the master shorten the send interval while there's
+//   data to transfer (down to the measured transfer time) and lengthen it when
+//   idle (up to LINK_CABLE_ADAPTIVE_MAX_INTERVAL)
+// - BURST: makes the master chain transfers while there's data to transfer,
+//   LINK_CABLE_BURST_GAP ticks apart (up to LINK_CABLE_BURST_MAX_TRANSFERS
+//   per frame)
+// (LINK_CABLE_DYNAMIC means "use the value passed to the constructor")
+struct LinkCableDefaultConfig {
+  static constexpr u32 MAX_PLAYERS = LINK_CABLE_MAX_PLAYERS;
+  static constexpr u32 QUEUE_SIZE = LINK_CABLE_QUEUE_SIZE;
+  static constexpr int BAUD_RATE = LINK_CABLE_DYNAMIC;
+  static constexpr int SEND_TIMER_ID = LINK_CABLE_DYNAMIC;
+  static constexpr bool ESCAPE_RESERVED_VALUES = false;
+  static constexpr bool RELIABLE = false;
+  static constexpr bool ADAPTIVE_INTERVAL = false;
+  static constexpr bool BURST = false;
+};
+
+template <typename Config = LinkCableDefaultConfig>
+class LinkCableT {
+  static_assert(Config::MAX_PLAYERS >= 2 &&
+                    Config::MAX_PLAYERS <= LINK_CABLE_MAX_PLAYERS,
+                "MAX_PLAYERS must be between 2 and 4");
+  static_assert(Config::BAUD_RATE >= LINK_CABLE_DYNAMIC &&
+                    Config::BAUD_RATE <= 3,
+                "BAUD_RATE must be a BaudRate or LINK_CABLE_DYNAMIC");
+  static_assert(Config::SEND_TIMER_ID >= LINK_CABLE_DYNAMIC &&
+                    Config::SEND_TIMER_ID <= 3,
+                "SEND_TIMER_ID must be 0-3 or LINK_CABLE_DYNAMIC");
+  static_assert((LINK_CABLE_RELIABLE_WINDOW_SIZE &
+                 (LINK_CABLE_RELIABLE_WINDOW_SIZE - 1)) == 0 &&
+                    LINK_CABLE_RELIABLE_WINDOW_SIZE <=
+                        LINK_CABLE_RELIABLE_SEQUENCE_MASK / 2,
+                "LINK_CABLE_RELIABLE_WINDOW_SIZE must be a power of two");
+
+  static constexpr bool ESCAPE =
+      Config::ESCAPE_RESERVED_VALUES || Config::RELIABLE;
+
  public:
+  static constexpr u32 MAX_PLAYERS = Config::MAX_PLAYERS;
+
   enum BaudRate {
     BAUD_RATE_0,  // 9600 bps
     BAUD_RATE_1,  // 38400 bps
@@ -80,49 +206,106 @@ class LinkCable {
     BAUD_RATE_3   // 115200 bps
   };
 
-  class U16Queue {
+  // (lock-free ring buffer for one producer and one consumer)
+  template <typename T, u32 Size>
+  class Queue {
+    static_assert(Size > 0 && (Size & (Size - 1)) == 0,
+                  "Queue size must be a power of two");
+
    public:
-    void push(u16 item) {
-      if (isFull())
-        pop();
+    LINK_CABLE_IWRAM_CODE bool push(T item) {  // (producer only)
+      u32 currentHead = head;
+      if (currentHead - tail == Size)
+        return false;
+
+      arr[currentHead & MASK] = item;
+      LINK_CABLE_BARRIER;
+      head = currentHead + 1;
+
+      return true;
+    }
+
+    LINK_CABLE_IWRAM_CODE T pop() {  // (consumer only)
+      u32 currentTail = tail;
+      if (head == currentTail)
+        return T();
+
+      T item = arr[currentTail & MASK];
+      LINK_CABLE_BARRIER;
+      tail = currentTail + 1;
 
-      rear = (rear + 1) % LINK_CABLE_QUEUE_SIZE;
-      arr[rear] = item;
-      count++;
+      return item;
     }
 
-    u16 pop() {
-      if (isEmpty())
-        return LINK_CABLE_NO_DATA;
+    LINK_CABLE_IWRAM_CODE u32 push(const T* items,
+                                   u32 count) {  // (producer only)
+      u32 currentHead = head;
+      u32 available = Size - (currentHead - tail);
+      if (count > available)
+        count = available;
 
-      auto x = arr[front];
-      front = (front + 1) % LINK_CABLE_QUEUE_SIZE;
-      count--;
+      for (u32 i = 0; i < count; i++)
+        arr[(currentHead + i) & MASK] = items[i];
+      LINK_CABLE_BARRIER;
+      head = currentHead + count;
 
-      return x;
+      return count;
     }
 
-    void clear() {
-      while (!isEmpty())
-        pop();
+    LINK_CABLE_IWRAM_CODE u32 pop(T* items, u32 max) {  // (consumer only)
+      u32 currentTail = tail;
+      u32 count = head - currentTail;
+      if (count > max)
+        count = max;
+
+      for (u32 i = 0; i < count; i++)
+        items[i] = arr[(currentTail + i) & MASK];
+      LINK_CABLE_BARRIER;
+      tail = currentTail + count;
+
+      return count;
     }
 
-    int size() { return count; }
-    bool isEmpty() { return size() == 0; }
-    bool isFull() { return size() == LINK_CABLE_QUEUE_SIZE; }
+    void clear() { tail = head; }  // (consumer only)
+
+    u32 size() { return head - tail; }
+    u32 available() { return Size - size(); }
+    bool isEmpty() { return head == tail; }
+    bool isFull() { return size() == Size; }
 
    private:
-    u16 arr[LINK_CABLE_QUEUE_SIZE];
-    vs32 front = 0;
-    vs32 rear = -1;
-    vu32 count = 0;
+    static constexpr u32 MASK = Size - 1;
+
+    T arr[Size];
+    vu32 head = 0;  // (written by the producer)
+    vu32 tail = 0;  // (written by the consumer)
   };
 
-  explicit LinkCable(BaudRate baudRate = BAUD_RATE_1,
-                     u32 timeout = LINK_CABLE_DEFAULT_TIMEOUT,
-                     u32 remoteTimeout = LINK_CABLE_DEFAULT_REMOTE_TIMEOUT,
-                     u16 interval = LINK_CABLE_DEFAULT_INTERVAL,
-                     u8 sendTimerId = LINK_CABLE_DEFAULT_SEND_TIMER_ID) {
+  using U16Queue = Queue<u16, Config::QUEUE_SIZE>;
+
+  // (all counters start at zero on `activate()`)
+  struct Stats {
+    u32 sentMessages = 0;      // (words transferred, excluding 'no data')
+    u32 receivedMessages = 0;  // (words received from remote players)
+    u32 droppedOutgoingMessages = 0;  // (rejected by `send(...)`)
+    u32 droppedIncomingMessages = 0;  // (full queue or unread on `consume()`)
+    u32 retransmittedMessages = 0;    // (RELIABLE mode only)
+    u32 resetsByTimeout = 0;          // (no serial IRQs for `timeout` frames)
+    u32 resetsByError = 0;            // (error or not ready bits in SIOCNT)
+    u32 vBlankIRQs = 0;
+    u32 serialIRQs = 0;
+    u32 timerIRQs = 0;
+    u32 outgoingQueueHighWaterMark = 0;
+    u32 incomingQueueHighWaterMark = 0;
+    u32 lastFrameSentMessages = 0;
+    u32 lastFrameReceivedMessages = 0;
+  };
+
+  explicit LinkCableT(BaudRate baudRate = BAUD_RATE_1,
+                      u32 timeout = LINK_CABLE_DEFAULT_TIMEOUT,
+                      u32 remoteTimeout = LINK_CABLE_DEFAULT_REMOTE_TIMEOUT,
+                      u16 interval = LINK_CABLE_DEFAULT_INTERVAL,
+                      u8 sendTimerId = LINK_CABLE_DEFAULT_SEND_TIMER_ID) {
     this->config.baudRate = baudRate;
     this->config.timeout = timeout;
     this->config.remoteTimeout = remoteTimeout;
@@ -133,6 +316,8 @@ class LinkCable {
   bool isActive() { return isEnabled; }
 
   void activate() {
+    LINK_CABLE_STATS(_stats = StatsState{});
+    clearMessages();
     reset();
     isEnabled = true;
   }
@@ -141,75 +326,107 @@ class LinkCable {
     isEnabled = false;
     isStateReady = false;
     isStateConsumed = false;
-    isResetting = false;
     resetState();
+    clearMessages();
     stop();
   }
 
   bool isConnected() {
-    return $state.playerCount > 1 &&
-           $state.currentPlayerId < $state.playerCount;
+    return $state->playerCount > 1 &&
+           $state->currentPlayerId < $state->playerCount;
   }
 
-  u8 playerCount() { return $state.playerCount; }
-  u8 currentPlayerId() { return $state.currentPlayerId; }
+  u8 playerCount() { return $state->playerCount; }
+  u8 currentPlayerId() { return $state->currentPlayerId; }
 
   bool canRead(u8 playerId) {
-    if (!isStateReady || isStateConsumed)
+    if (!isStateReady || isStateConsumed ||
+        playerId >= Config::MAX_PLAYERS)
       return false;
 
     LINK_CABLE_BARRIER;
 
-    return !$state.incomingMessages[playerId].isEmpty();
+    return !$state->incomingMessages[playerId].isEmpty();
   }
 
   u16 read(u8 playerId) {
-    if (!isStateReady || isStateConsumed)
+    if (!isStateReady || isStateConsumed ||
+        playerId >= Config::MAX_PLAYERS)
       return LINK_CABLE_NO_DATA;
 
     LINK_CABLE_BARRIER;
 
-    return $state.incomingMessages[playerId].pop();
+    return $state->incomingMessages[playerId].pop();
+  }
+
+  u32 readAll(u8 playerId, u16* out, u32 max) {
+    if (!isStateReady || isStateConsumed ||
+        playerId >= Config::MAX_PLAYERS)
+      return 0;
+
+    LINK_CABLE_BARRIER;
+
+    return $state->incomingMessages[playerId].pop(out, max);
   }
 
   void consume() { isStateConsumed = true; }
 
-  void send(u16 data) {
-    if (data == LINK_CABLE_DISCONNECTED || data == LINK_CABLE_NO_DATA)
-      return;
+  Stats getStats() {
+#if LINK_CABLE_ENABLE_STATS
+    return _stats.stats;
+#else
+    return Stats{};
+#endif
+  }
 
-    LINK_CABLE_BARRIER;
-    isAddingMessage = true;
-    LINK_CABLE_BARRIER;
+  bool send(u16 data) {
+    bool success = queue(data);
 
-    _state.outgoingMessages.push(data);
+    LINK_CABLE_STATS(updateOutgoingStats(success ? 0 : 1));
 
-    LINK_CABLE_BARRIER;
-    isAddingMessage = false;
-    LINK_CABLE_BARRIER;
+    return success;
+  }
 
-    if (isResetting) {
-      _state.outgoingMessages.clear();
-      isResetting = false;
-    }
+  u32 send(const u16* data, u32 count) {
+    u32 sentCount = queue(data, count);
+
+    LINK_CABLE_STATS(updateOutgoingStats(count - sentCount));
+
+    return sentCount;
   }
 
-  void _onVBlank() {
+  LINK_CABLE_IWRAM_CODE void _onVBlank() {
     if (!isEnabled)
       return;
 
+#if LINK_CABLE_ENABLE_STATS
+    Stats& stats = _stats.stats;
+    stats.vBlankIRQs++;
+    stats.lastFrameSentMessages = stats.sentMessages - _stats.frameSent;
+    stats.lastFrameReceivedMessages =
+        stats.receivedMessages - _stats.frameReceived;
+    _stats.frameSent = stats.sentMessages;
+    _stats.frameReceived = stats.receivedMessages;
+#endif
+
     if (!_state.IRQFlag)
       _state.IRQTimeout++;
 
     _state.IRQFlag = false;
+    _state.burstTransfers = 0;
+
+    if constexpr (Config::RELIABLE)
+      _state.reliable.frames++;
 
     copyState();
   }
 
-  void _onSerial() {
+  LINK_CABLE_IWRAM_CODE void _onSerial() {
     if (!isEnabled)
       return;
 
+    LINK_CABLE_STATS(_stats.stats.serialIRQs++);
+
     if (resetIfNeeded()) {
       copyState();
       return;
@@ -218,55 +435,119 @@ class LinkCable {
     _state.IRQFlag = true;
     _state.IRQTimeout = 0;
 
+    if constexpr (Config::ADAPTIVE_INTERVAL)
+      measureTransfer();
+
     u8 newPlayerCount = 0;
-    for (u32 i = 0; i < LINK_CABLE_MAX_PLAYERS; i++) {
+    bool didReceive = false;
+    for (u32 i = 0; i < Config::MAX_PLAYERS; i++) {
       u16 data = REG_SIOMULTI[i];
 
+      if constexpr (ESCAPE) {
+        // (senders never put these between an escape and its code, so they
+        //  mean that the remote's traffic restarted, e.g. after a reset)
+        if (data == LINK_CABLE_NO_DATA || data == LINK_CABLE_DISCONNECTED)
+          _state.isEscaping[i] = false;
+      }
+
+      if constexpr (Config::RELIABLE) {
+        if ((data == LINK_CABLE_DISCONNECTED) == (_state.timeouts[i] == 0))
+          onLinkChanged();
+      }
+
       if (data != LINK_CABLE_DISCONNECTED) {
-        if (data != LINK_CABLE_NO_DATA && i != state.currentPlayerId)
-          state.incomingMessages[i].push(data);
+        if (data != LINK_CABLE_NO_DATA && i != state->currentPlayerId) {
+          LINK_CABLE_STATS(_stats.stats.receivedMessages++);
+          didReceive = true;
+          receive(i, data);
+        }
         newPlayerCount++;
         _state.timeouts[i] = 0;
       } else if (_state.timeouts[i] > LINK_CABLE_REMOTE_TIMEOUT_OFFLINE) {
         _state.timeouts[i]++;
 
         if (_state.timeouts[i] >= (int)config.remoteTimeout) {
-          state.incomingMessages[i].clear();
+          state->incomingMessages[i].clear();
+          _state.isEscaping[i] = false;
+          if constexpr (Config::RELIABLE)
+            onPlayerDisconnected(i);
           _state.timeouts[i] = LINK_CABLE_REMOTE_TIMEOUT_OFFLINE;
         } else
           newPlayerCount++;
       }
     }
 
-    state.playerCount = newPlayerCount;
-    state.currentPlayerId =
+    state->playerCount = newPlayerCount;
+    state->currentPlayerId =
         (REG_SIOCNT & (0b11 << LINK_CABLE_BITS_PLAYER_ID)) >>
         LINK_CABLE_BITS_PLAYER_ID;
 
+    if constexpr (Config::ADAPTIVE_INTERVAL) {
+      if (didReceive)
+        _state.adaptive.hadTraffic = true;
+    }
+
     if (!isMaster())
       sendPendingData();
+    else if constexpr (Config::BURST) {
+      if (didReceive || hasPendingData())
+        scheduleBurst();
+    }
 
     copyState();
   }
 
-  void _onTimer() {
+  LINK_CABLE_IWRAM_CODE void _onTimer() {
     if (!isEnabled)
       return;
 
+    LINK_CABLE_STATS(_stats.stats.timerIRQs++);
+
     if (didTimeout()) {
+      LINK_CABLE_STATS(_stats.stats.resetsByTimeout++);
       reset();
       copyState();
       return;
     }
 
-    if (isMaster() && isReady() && !isSending())
+    if constexpr (Config::BURST) {
+      if (_state.isBursting) {
+        // (go back to the regular interval)
+        _state.isBursting = false;
+        stopTimer();
+        startTimer(sendInterval());
+      }
+    }
+
+    bool isBusy = isSending();
+    if (isMaster() && isReady() && !isBusy)
       sendPendingData();
 
+    if constexpr (Config::ADAPTIVE_INTERVAL)
+      adaptInterval(isBusy);
+
     copyState();
   }
 
+  // (interrupt service routines bound to an instance with static storage,
+  //  so they don't read a global pointer and work with any `Config`)
+  template <LinkCableT& instance>
+  struct ISR {
+    LINK_CABLE_IWRAM_CODE static void VBLANK() {
+      LINK_CABLE_PROFILE(CABLE_VBLANK, instance._onVBlank());
+    }
+
+    LINK_CABLE_IWRAM_CODE static void SERIAL() {
+      LINK_CABLE_PROFILE(CABLE_SERIAL, instance._onSerial());
+    }
+
+    LINK_CABLE_IWRAM_CODE static void TIMER() {
+      LINK_CABLE_PROFILE(CABLE_TIMER, instance._onTimer());
+    }
+  };
+
  private:
-  struct Config {
+  struct RuntimeConfig {
     BaudRate baudRate;
     u32 timeout;
     u32 remoteTimeout;
@@ -274,28 +555,165 @@ class LinkCable {
     u8 sendTimerId;
   };
 
+#if LINK_CABLE_ENABLE_STATS
+  struct StatsState {
+    Stats stats;
+    u32 frameSent = 0;      // (`sentMessages` on the last VBlank)
+    u32 frameReceived = 0;  // (`receivedMessages` on the last VBlank)
+  };
+#endif
+
+  bool queue(u16 data) {
+    if constexpr (Config::RELIABLE) {
+      // (reliable mode escapes words when transferring them)
+    } else if constexpr (Config::ESCAPE_RESERVED_VALUES) {
+      if (needsEscape(data)) {
+        u16 sequence[2] = {LINK_CABLE_ESCAPE, escape(data)};
+        return _state.outgoingMessages.available() >= 2 &&
+               _state.outgoingMessages.push(sequence, 2) == 2;
+      }
+    } else if (data == LINK_CABLE_DISCONNECTED || data == LINK_CABLE_NO_DATA)
+      return false;
+
+    return _state.outgoingMessages.push(data);
+  }
+
+  u32 queue(const u16* data, u32 count) {
+    if constexpr (Config::RELIABLE) {
+      return _state.outgoingMessages.push(data, count);
+    } else if constexpr (Config::ESCAPE_RESERVED_VALUES) {
+      u16 encoded[Config::QUEUE_SIZE];
+      u32 available = _state.outgoingMessages.available();
+      u32 encodedCount = 0;
+      u32 acceptedCount = 0;
+      while (acceptedCount < count) {
+        u16 word = data[acceptedCount];
+        if (needsEscape(word)) {
+          if (encodedCount + 2 > available)
+            break;
+          encoded[encodedCount++] = LINK_CABLE_ESCAPE;
+          encoded[encodedCount++] = escape(word);
+        } else {
+          if (encodedCount + 1 > available)
+            break;
+          encoded[encodedCount++] = word;
+        }
+        acceptedCount++;
+      }
+
+      _state.outgoingMessages.push(encoded, encodedCount);
+      return acceptedCount;
+    } else {
+      u32 validCount = 0;
+      while (validCount < count &&
+             data[validCount] != LINK_CABLE_DISCONNECTED &&
+             data[validCount] != LINK_CABLE_NO_DATA)
+        validCount++;
+
+      return _state.outgoingMessages.push(data, validCount);
+    }
+  }
+
+#if LINK_CABLE_ENABLE_STATS
+  void updateOutgoingStats(u32 droppedMessages) {
+    Stats& stats = _stats.stats;
+    u32 size = _state.outgoingMessages.size();
+    stats.droppedOutgoingMessages += droppedMessages;
+    if (size > stats.outgoingQueueHighWaterMark)
+      stats.outgoingQueueHighWaterMark = size;
+  }
+
+  void updateIncomingStats(u8 playerId, bool success) {
+    Stats& stats = _stats.stats;
+    u32 size = state->incomingMessages[playerId].size();
+    if (!success)
+      stats.droppedIncomingMessages++;
+    if (size > stats.incomingQueueHighWaterMark)
+      stats.incomingQueueHighWaterMark = size;
+  }
+#endif
+
   struct ExternalState {
-    U16Queue incomingMessages[LINK_CABLE_MAX_PLAYERS];
+    U16Queue incomingMessages[Config::MAX_PLAYERS];
     u8 playerCount;
     u8 currentPlayerId;
   };
 
+  static constexpr u32 RELIABLE_WINDOW_SIZE =
+      Config::RELIABLE ? LINK_CABLE_RELIABLE_WINDOW_SIZE : 1;
+  static constexpr u32 RELIABLE_MARK_INTERVAL =
+      Config::RELIABLE ? LINK_CABLE_RELIABLE_MARK_INTERVAL : 1;
+
+  struct ReliableReceiver {
+    u32 session = LINK_CABLE_RELIABLE_NO_SESSION;
+    bool hasJoined = false;
+    bool isSynced = false;
+    bool needsAck = false;
+    bool needsResync = false;
+    bool isWaitingCheck = false;
+    bool isWaitingSession = false;
+    u16 checkedCode = 0;  // (a mark or an ack, waiting for its check word)
+    u16 hello = 0;
+    u16 checksum = LINK_CABLE_RELIABLE_CHECKSUM_SEED;
+    u32 committed = 0;  // (sequence of the next word to deliver)
+    u32 position = 0;   // (sequence of the next word to arrive)
+    u16 pending[RELIABLE_MARK_INTERVAL];
+    u32 pendingCount = 0;
+  };
+
+  struct ReliableState {
+    u16 window[RELIABLE_WINDOW_SIZE];
+    u32 base = 0;  // (oldest word not acknowledged by everyone)
+    u32 next = 0;  // (next word to transfer)
+    u32 end = 0;   // (next free slot of the window)
+    u32 wordsSinceMark = 0;
+    u32 idleTransfers = 0;
+    u32 transfersSinceGoBack = 0;
+    u32 frames = 0;  // (since `activate()`, to pick the session at link-up)
+    u32 session = LINK_CABLE_RELIABLE_NO_SESSION;
+    u8 playerId = 0;
+    bool needsHello = false;
+    bool needsMark = false;
+    u16 checksum = LINK_CABLE_RELIABLE_CHECKSUM_SEED;
+    u16 extraWords[3];  // (words that follow an escape)
+    u32 extraWordCount = 0;
+    u32 extraWordIndex = 0;
+    u32 acks[Config::MAX_PLAYERS] = {};
+    bool hasAcked[Config::MAX_PLAYERS] = {};
+    ReliableReceiver receivers[Config::MAX_PLAYERS];
+  };
+
+  struct AdaptiveState {
+    u32 interval = 0;       // (current send interval, in timer ticks)
+    u32 minInterval = 0;    // (measured transfer time + margin)
+    u16 transferStart = 0;  // (timer count when the last transfer started)
+    bool isMeasuring = false;
+    bool hadTraffic = false;  // (remote data arrived since the last tick)
+  };
+
   struct InternalState {
     U16Queue outgoingMessages;
-    int timeouts[LINK_CABLE_MAX_PLAYERS];
+    int timeouts[Config::MAX_PLAYERS];
+    bool isEscaping[Config::MAX_PLAYERS];
     bool IRQFlag;
     u32 IRQTimeout;
+    ReliableState reliable;
+    AdaptiveState adaptive;
+    u32 burstTransfers;  // (chained transfers in the current frame)
+    bool isBursting;
   };
 
-  ExternalState state;   // (updated state / back buffer)
-  ExternalState $state;  // (visible state / front buffer)
-  InternalState _state;  // (internal state)
-  Config config;
+  ExternalState states[2];
+  ExternalState* state = &states[0];   // (updated state / back buffer)
+  ExternalState* $state = &states[1];  // (visible state / front buffer)
+  InternalState _state;                // (internal state)
+#if LINK_CABLE_ENABLE_STATS
+  StatsState _stats;
+#endif
+  RuntimeConfig config;
   bool isEnabled = false;
   volatile bool isStateReady = false;
   volatile bool isStateConsumed = false;
-  volatile bool isAddingMessage = false;
-  volatile bool isResetting = false;
 
   bool isReady() { return isBitHigh(LINK_CABLE_BIT_READY); }
   bool hasError() { return isBitHigh(LINK_CABLE_BIT_ERROR); }
@@ -303,24 +721,581 @@ class LinkCable {
   bool isSending() { return isBitHigh(LINK_CABLE_BIT_START); }
   bool didTimeout() { return _state.IRQTimeout >= config.timeout; }
 
-  void sendPendingData() {
-    if (isAddingMessage)
-      return;
+  BaudRate baudRate() {
+    if constexpr (Config::BAUD_RATE == LINK_CABLE_DYNAMIC)
+      return config.baudRate;
+    else
+      return (BaudRate)Config::BAUD_RATE;
+  }
 
-    LINK_CABLE_BARRIER;
+  u32 sendInterval() {
+    if constexpr (Config::ADAPTIVE_INTERVAL)
+      return _state.adaptive.interval;
+    else
+      return config.interval;
+  }
 
-    transfer(_state.outgoingMessages.pop());
+  u8 sendTimerId() {
+    if constexpr (Config::SEND_TIMER_ID == LINK_CABLE_DYNAMIC)
+      return config.sendTimerId;
+    else
+      return Config::SEND_TIMER_ID;
+  }
+
+  LINK_CABLE_IWRAM_CODE void sendPendingData() {
+    u16 data;
+    if constexpr (Config::RELIABLE)
+      data = nextReliableWord();
+    else
+      data = _state.outgoingMessages.pop();
+
+#if LINK_CABLE_ENABLE_STATS
+    if (data != LINK_CABLE_NO_DATA)
+      _stats.stats.sentMessages++;
+#endif
+
+    transfer(data);
   }
 
   void transfer(u16 data) {
     REG_SIOMLT_SEND = data;
 
-    if (isMaster())
+    if (isMaster()) {
+      if constexpr (Config::ADAPTIVE_INTERVAL) {
+        _state.adaptive.transferStart = REG_TM[sendTimerId()].count;
+        _state.adaptive.isMeasuring = true;
+      }
       setBitHigh(LINK_CABLE_BIT_START);
+    }
+  }
+
+  void adaptInterval(bool wasBusy) {
+    AdaptiveState& adaptive = _state.adaptive;
+    u32 interval = adaptive.interval;
+
+    if (!isMaster() || !isReady()) {
+      // (slaves only use the timer to check timeouts)
+      interval = growInterval(interval);
+    } else if (wasBusy) {
+      // (the previous transfer didn't finish in time)
+      adaptive.isMeasuring = false;
+      adaptive.minInterval = growInterval(adaptive.minInterval);
+      interval = std::max(growInterval(interval), adaptive.minInterval);
+    } else if (isBackedUp())
+      interval = std::max(interval / 2, adaptive.minInterval);
+    else if (!adaptive.hadTraffic && !hasPendingData())
+      interval = growInterval(interval);
+
+    adaptive.hadTraffic = false;
+    setInterval(interval);
+  }
+
+  void measureTransfer() {
+    AdaptiveState& adaptive = _state.adaptive;
+    if (!adaptive.isMeasuring || !isMaster())
+      return;
+    adaptive.isMeasuring = false;
+
+    u16 now = REG_TM[sendTimerId()].count;
+    if (now < adaptive.transferStart) {
+      // (the timer overflowed during the transfer)
+      adaptive.minInterval = growInterval(adaptive.interval);
+      return;
+    }
+
+    u32 elapsed = now - adaptive.transferStart;
+    adaptive.minInterval =
+        std::min(elapsed + LINK_CABLE_ADAPTIVE_MARGIN,
+                 (u32)LINK_CABLE_ADAPTIVE_MAX_INTERVAL);
+  }
+
+  void scheduleBurst() {
+    if (_state.burstTransfers >= LINK_CABLE_BURST_MAX_TRANSFERS)
+      return;
+
+    // (restart the timer, so the next transfer starts after a short gap
+    //  that gives the slaves time to refill their outgoing data)
+    _state.burstTransfers++;
+    _state.isBursting = true;
+    stopTimer();
+    startTimer(LINK_CABLE_BURST_GAP);
+  }
+
+  bool isBackedUp() {
+    // (more words are waiting than the next transfer can send)
+    if constexpr (Config::RELIABLE) {
+      ReliableState& reliable = _state.reliable;
+      if (reliable.end - reliable.next > 1)
+        return true;
+    }
+
+    return _state.outgoingMessages.size() > 1;
+  }
+
+  bool hasPendingData() {
+    if constexpr (Config::RELIABLE) {
+      ReliableState& reliable = _state.reliable;
+      if (reliable.extraWordIndex < reliable.extraWordCount ||
+          reliable.next != reliable.end)
+        return true;
+    }
+
+    return !_state.outgoingMessages.isEmpty();
+  }
+
+  u32 growInterval(u32 interval) {
+    return std::min(interval * 2 + 1,
+                    (u32)LINK_CABLE_ADAPTIVE_MAX_INTERVAL);
+  }
+
+  void setInterval(u32 interval) {
+    if (interval == _state.adaptive.interval)
+      return;
+
+    // (the new reload value is used after the next overflow)
+    _state.adaptive.interval = interval;
+    REG_TM[sendTimerId()].start = -interval;
+  }
+
+  LINK_CABLE_IWRAM_CODE void receive(u8 playerId, u16 data) {
+    if constexpr (ESCAPE) {
+      if (data == LINK_CABLE_ESCAPE) {
+        _state.isEscaping[playerId] = true;
+        return;
+      }
+
+      if (_state.isEscaping[playerId]) {
+        _state.isEscaping[playerId] = false;
+
+        if constexpr (Config::RELIABLE) {
+          if (data > LINK_CABLE_ESCAPED_ESCAPE)
+            return receiveReliableControl(playerId, data);
+        }
+
+        data = unescape(data);
+      }
+    }
+
+    if constexpr (Config::RELIABLE)
+      receiveReliableData(playerId, data);
+    else {
+      [[maybe_unused]] bool success =
+          state->incomingMessages[playerId].push(data);
+      LINK_CABLE_STATS(updateIncomingStats(playerId, success));
+    }
+  }
+
+  LINK_CABLE_IWRAM_CODE u16 nextReliableWord() {
+    ReliableState& reliable = _state.reliable;
+
+    if (reliable.extraWordIndex < reliable.extraWordCount)
+      return reliable.extraWords[reliable.extraWordIndex++];
+
+    if (state->currentPlayerId != reliable.playerId) {
+      // (the players were renumbered: introduce ourselves again)
+      reliable.playerId = state->currentPlayerId;
+      goBack();
+    }
+
+    reliable.transfersSinceGoBack++;
+
+    for (u32 i = 0; i < Config::MAX_PLAYERS; i++) {
+      ReliableReceiver& receiver = reliable.receivers[i];
+      if (receiver.needsResync) {
+        receiver.needsResync = false;
+        return control(LINK_CABLE_RELIABLE_CONTROL_RESYNC |
+                       (i << LINK_CABLE_RELIABLE_BITS_PLAYER_ID));
+      }
+      if (receiver.needsAck) {
+        u16 sequence = receiver.committed & LINK_CABLE_RELIABLE_SEQUENCE_MASK;
+        receiver.needsAck = false;
+        u16 code = LINK_CABLE_RELIABLE_CONTROL_ACK |
+                   (i << LINK_CABLE_RELIABLE_BITS_PLAYER_ID) | sequence;
+        return checkedControl(code, controlCheck(receiver.session, code));
+      }
+    }
+
+    if (reliable.needsHello && state->playerCount > 1) {
+      if (reliable.session == LINK_CABLE_RELIABLE_NO_SESSION)
+        reliable.session = newSession();
+
+      reliable.needsHello = false;
+      // (the session is split in two control words, so a lost one can't be
+      //  mistaken for data)
+      control(LINK_CABLE_RELIABLE_CONTROL_HELLO | (reliable.session >> 8));
+      addExtraWord(LINK_CABLE_ESCAPE);
+      addExtraWord(LINK_CABLE_RELIABLE_CONTROL_SESSION |
+                   (reliable.session & 0xff));
+      return LINK_CABLE_ESCAPE;
+    }
+
+    if (reliable.base != reliable.end &&
+        ++reliable.idleTransfers > LINK_CABLE_RELIABLE_RETRANSMIT_TIMEOUT)
+      goBack();
+
+    if (reliable.next == reliable.end &&
+        reliable.end - reliable.base < RELIABLE_WINDOW_SIZE &&
+        !_state.outgoingMessages.isEmpty()) {
+      reliable.window[reliable.end % RELIABLE_WINDOW_SIZE] =
+          _state.outgoingMessages.pop();
+      reliable.end++;
+    }
+
+    bool hasData = reliable.next != reliable.end;
+    if (reliable.needsMark ||
+        reliable.wordsSinceMark == RELIABLE_MARK_INTERVAL ||
+        (reliable.wordsSinceMark > 0 && !hasData)) {
+      u16 checksum = reliable.checksum;
+      reliable.needsMark = false;
+      reliable.wordsSinceMark = 0;
+      reliable.checksum = LINK_CABLE_RELIABLE_CHECKSUM_SEED;
+
+      // (a base mark can make receivers skip words, so it checks itself
+      //  instead of the block, which was acknowledged already)
+      bool isBase = reliable.next == reliable.base;
+      u16 code = (isBase ? LINK_CABLE_RELIABLE_CONTROL_MARK_BASE
+                         : LINK_CABLE_RELIABLE_CONTROL_MARK) |
+                 (reliable.next & LINK_CABLE_RELIABLE_SEQUENCE_MASK);
+      return checkedControl(code, isBase
+                                      ? controlCheck(reliable.session, code)
+                                      : blockCheck(reliable.session, checksum));
+    }
+
+    if (!hasData)
+      return LINK_CABLE_NO_DATA;
+
+    u16 data = reliable.window[reliable.next % RELIABLE_WINDOW_SIZE];
+    reliable.next++;
+    reliable.wordsSinceMark++;
+    reliable.checksum = updateChecksum(reliable.checksum, data);
+
+    return needsEscape(data) ? control(escape(data)) : data;
+  }
+
+  u16 control(u16 code) {
+    _state.reliable.extraWordCount = 0;
+    _state.reliable.extraWordIndex = 0;
+    addExtraWord(code);
+    return LINK_CABLE_ESCAPE;
+  }
+
+  u16 checkedControl(u16 code, u16 check) {
+    // (a lost code makes the receiver take the next word as one, so codes
+    //  that move sequences are followed by a check word)
+    control(code);
+    if (needsEscape(check)) {
+      addExtraWord(LINK_CABLE_ESCAPE);
+      addExtraWord(escape(check));
+    } else
+      addExtraWord(check);
+    return LINK_CABLE_ESCAPE;
+  }
+
+  void addExtraWord(u16 word) {
+    _state.reliable.extraWords[_state.reliable.extraWordCount++] = word;
+  }
+
+  // (checks include the sender's session, so nobody applies words or codes
+  //  meant for the previous owner of a player id while the players are
+  //  renumbered, even if both senders were at the same sequence)
+  u16 controlCheck(u32 session, u16 code) {
+    return updateChecksum(LINK_CABLE_RELIABLE_CHECKSUM_SEED ^ session, code);
+  }
+
+  u16 blockCheck(u32 session, u16 checksum) { return checksum ^ session; }
+
+  u32 newSession() {
+    // (the time between `activate()` and the link-up varies between
+    //  consoles, and the player id sets apart the ones that link up together)
+    u32 lines = _state.reliable.frames * LINK_CABLE_TOTAL_LINES + REG_VCOUNT;
+    return ((lines << 2) | state->currentPlayerId) & 0xffff;
+  }
+
+  u16 updateChecksum(u16 checksum, u16 data) {
+    return ((checksum << 1) | (checksum >> 15)) + data;
+  }
+
+  void goBack() {
+    ReliableState& reliable = _state.reliable;
+    LINK_CABLE_STATS(_stats.stats.retransmittedMessages +=
+                     reliable.next - reliable.base);
+    reliable.next = reliable.base;
+    reliable.wordsSinceMark = 0;
+    reliable.checksum = LINK_CABLE_RELIABLE_CHECKSUM_SEED;
+    reliable.idleTransfers = 0;
+    reliable.transfersSinceGoBack = 0;
+    reliable.needsHello = true;
+    reliable.needsMark = true;
+  }
+
+  LINK_CABLE_IWRAM_CODE void receiveReliableData(u8 playerId, u16 data) {
+    ReliableReceiver& receiver = _state.reliable.receivers[playerId];
+    receiver.isWaitingSession = false;
+    if (receiver.isWaitingCheck) {
+      receiver.isWaitingCheck = false;
+      return isAck(receiver.checkedCode)
+                 ? receiveReliableAck(playerId, data)
+                 : receiveReliableMark(playerId, data);
+    }
+    if (!receiver.isSynced)
+      return;
+
+    receiver.checksum = updateChecksum(receiver.checksum, data);
+    if ((int)(receiver.position - receiver.committed) < 0) {
+      receiver.position++;  // (already delivered)
+      return;
+    }
+
+    if (receiver.pendingCount == RELIABLE_MARK_INTERVAL) {
+      receiver.isSynced = false;
+      receiver.needsResync = true;
+      return;
+    }
+
+    receiver.pending[receiver.pendingCount++] = data;
+    receiver.position++;
+  }
+
+  LINK_CABLE_IWRAM_CODE void receiveReliableControl(u8 playerId, u16 code) {
+    ReliableState& reliable = _state.reliable;
+    ReliableReceiver& receiver = reliable.receivers[playerId];
+    u16 type = code & LINK_CABLE_RELIABLE_CONTROL_MASK;
+    bool isWaitingSession = receiver.isWaitingSession;
+    receiver.isWaitingSession = false;
+    if (receiver.isWaitingCheck) {
+      // (the check word was lost: a lost ack is harmless, a lost mark
+      //  invalidates its block)
+      receiver.isWaitingCheck = false;
+      if (!isAck(receiver.checkedCode))
+        return failReliableReceiver(receiver);
+    }
+
+    u8 targetId = (code >> LINK_CABLE_RELIABLE_BITS_PLAYER_ID) & 0b11;
+
+    switch (type) {
+      case LINK_CABLE_RELIABLE_CONTROL_MARK:
+      case LINK_CABLE_RELIABLE_CONTROL_MARK_BASE: {
+        // (the block checksum comes next)
+        receiver.checkedCode = code;
+        receiver.isWaitingCheck = true;
+        break;
+      }
+      case LINK_CABLE_RELIABLE_CONTROL_HELLO: {
+        // (the low half of the session comes next)
+        receiver.hello = code;
+        receiver.isWaitingSession = true;
+        break;
+      }
+      case LINK_CABLE_RELIABLE_CONTROL_SESSION: {
+        if (isWaitingSession)
+          receiveReliableHello(playerId, code);
+        break;
+      }
+      case LINK_CABLE_RELIABLE_CONTROL_ACK:
+      case LINK_CABLE_RELIABLE_CONTROL_ACK + 0x1000:
+      case LINK_CABLE_RELIABLE_CONTROL_ACK + 0x2000:
+      case LINK_CABLE_RELIABLE_CONTROL_ACK + 0x3000: {
+        // (the check word comes next)
+        receiver.checkedCode = code;
+        receiver.isWaitingCheck = true;
+        break;
+      }
+      case LINK_CABLE_RELIABLE_CONTROL_RESYNC:
+      case LINK_CABLE_RELIABLE_CONTROL_RESYNC + 0x1000:
+      case LINK_CABLE_RELIABLE_CONTROL_RESYNC + 0x2000:
+      case LINK_CABLE_RELIABLE_CONTROL_RESYNC + 0x3000: {
+        if (targetId == state->currentPlayerId && !reliable.needsMark &&
+            reliable.transfersSinceGoBack > RELIABLE_MARK_INTERVAL * 2)
+          goBack();
+        break;
+      }
+      default: {
+        failReliableReceiver(receiver);
+      }
+    }
+  }
+
+  LINK_CABLE_IWRAM_CODE void receiveReliableHello(u8 playerId, u16 code) {
+    ReliableState& reliable = _state.reliable;
+    ReliableReceiver& receiver = reliable.receivers[playerId];
+    u32 session = ((receiver.hello & 0xff) << 8) | (code & 0xff);
+    if (receiver.session == session)
+      return;
+
+    // (states follow their sessions: a renumbered sender takes its state
+    //  from its previous player id, and the one that was here is kept there,
+    //  in case its owner comes back)
+    ReliableReceiver newReceiver = ReliableReceiver{};
+    newReceiver.session = session;
+    for (u32 i = 0; i < Config::MAX_PLAYERS; i++) {
+      if (i != playerId && reliable.receivers[i].session == session) {
+        newReceiver = reliable.receivers[i];
+        reliable.receivers[i] = receiver;
+        unsyncReliableReceiver(reliable.receivers[i]);
+        break;
+      }
+    }
+    unsyncReliableReceiver(newReceiver);
+    receiver = newReceiver;
+  }
+
+  LINK_CABLE_IWRAM_CODE void receiveReliableAck(u8 playerId, u16 check) {
+    ReliableState& reliable = _state.reliable;
+    u16 code = reliable.receivers[playerId].checkedCode;
+    if (check != controlCheck(reliable.session, code))
+      return;
+
+    u8 targetId = (code >> LINK_CABLE_RELIABLE_BITS_PLAYER_ID) & 0b11;
+    if (targetId != state->currentPlayerId)
+      return;
+
+    u16 sequence = code & LINK_CABLE_RELIABLE_SEQUENCE_MASK;
+    int offset = toSequenceOffset(sequence, reliable.base);
+    if (offset < 0 || (u32)offset > reliable.end - reliable.base)
+      return;
+
+    reliable.acks[playerId] = reliable.base + offset;
+    reliable.hasAcked[playerId] = true;
+    updateReliableBase();
+  }
+
+  LINK_CABLE_IWRAM_CODE void receiveReliableMark(u8 playerId, u16 checksum) {
+    ReliableReceiver& receiver = _state.reliable.receivers[playerId];
+    u16 sequence = receiver.checkedCode & LINK_CABLE_RELIABLE_SEQUENCE_MASK;
+    bool isBase = (receiver.checkedCode & LINK_CABLE_RELIABLE_CONTROL_MASK) ==
+                  LINK_CABLE_RELIABLE_CONTROL_MARK_BASE;
+
+    if (isBase) {
+      if (checksum != controlCheck(receiver.session, receiver.checkedCode))
+        return failReliableReceiver(receiver);
+      receiver.pendingCount = 0;  // (the block was acknowledged already)
+    }
+
+    if (!receiver.hasJoined) {
+      if (!isBase || receiver.session == LINK_CABLE_RELIABLE_NO_SESSION) {
+        receiver.needsResync = true;
+        return;
+      }
+      receiver.hasJoined = true;
+      receiver.committed = sequence;
+    } else if (!isBase && receiver.isSynced &&
+               checksum == blockCheck(receiver.session, receiver.checksum) &&
+               sequence ==
+                   (receiver.position & LINK_CABLE_RELIABLE_SEQUENCE_MASK)) {
+      receiver.committed += state->incomingMessages[playerId].push(
+          receiver.pending, receiver.pendingCount);
+      LINK_CABLE_STATS(updateIncomingStats(playerId, true));
+    }
+
+    int offset = toSequenceOffset(sequence, receiver.committed);
+    if (offset > 0 && isBase) {
+      // (the sender gave up on us, so those words are lost)
+      receiver.committed += offset;
+      offset = 0;
+    }
+
+    receiver.position = receiver.committed + offset;
+    receiver.pendingCount = 0;
+    receiver.checksum = LINK_CABLE_RELIABLE_CHECKSUM_SEED;
+    receiver.isSynced = offset <= 0;
+    receiver.needsResync = !receiver.isSynced;
+    receiver.needsAck = true;
+  }
+
+  bool isAck(u16 code) {
+    return (code & LINK_CABLE_RELIABLE_CONTROL_MASK) >=
+               LINK_CABLE_RELIABLE_CONTROL_ACK &&
+           (code & LINK_CABLE_RELIABLE_CONTROL_MASK) <
+               LINK_CABLE_RELIABLE_CONTROL_RESYNC;
+  }
+
+  void unsyncReliableReceiver(ReliableReceiver& receiver) {
+    receiver.isSynced = false;
+    receiver.isWaitingCheck = false;
+    receiver.isWaitingSession = false;
+    receiver.needsAck = false;
+    receiver.needsResync = false;
+    receiver.pendingCount = 0;
+  }
+
+  void failReliableReceiver(ReliableReceiver& receiver) {
+    receiver.pendingCount = 0;
+    receiver.isSynced = false;
+    receiver.isWaitingCheck = false;
+    receiver.needsResync = receiver.hasJoined;
+  }
+
+  void updateReliableBase() {
+    ReliableState& reliable = _state.reliable;
+    u32 newBase = reliable.end;
+    bool hasAckers = false;
+
+    for (u32 i = 0; i < Config::MAX_PLAYERS; i++) {
+      if (i == state->currentPlayerId)
+        continue;
+      if (!reliable.hasAcked[i]) {
+        // (connected players that didn't join yet still need every word)
+        if (i < state->playerCount)
+          return;
+        continue;
+      }
+      hasAckers = true;
+      if ((int)(reliable.acks[i] - newBase) < 0)
+        newBase = reliable.acks[i];
+    }
+
+    if (!hasAckers || newBase == reliable.base)
+      return;
+
+    reliable.base = newBase;
+    reliable.idleTransfers = 0;
+    if ((int)(reliable.next - newBase) < 0) {
+      reliable.next = newBase;
+      reliable.needsMark = true;
+    }
+  }
+
+  int toSequenceOffset(u16 sequence, u32 reference) {
+    int offset = (sequence - reference) & LINK_CABLE_RELIABLE_SEQUENCE_MASK;
+    return offset > (int)(LINK_CABLE_RELIABLE_SEQUENCE_MASK / 2)
+               ? offset - (int)(LINK_CABLE_RELIABLE_SEQUENCE_MASK + 1)
+               : offset;
+  }
+
+  void onLinkChanged() {
+    // (a player connected or disconnected, so the ones after it were
+    //  renumbered and the acks no longer match their player ids)
+    for (u32 i = 0; i < Config::MAX_PLAYERS; i++)
+      _state.reliable.hasAcked[i] = false;
+  }
+
+  void onPlayerDisconnected(u8 playerId) {
+    _state.reliable.hasAcked[playerId] = false;
+    unsyncReliableReceiver(_state.reliable.receivers[playerId]);
+    updateReliableBase();
+  }
+
+  bool needsEscape(u16 data) {
+    return data == LINK_CABLE_NO_DATA || data == LINK_CABLE_DISCONNECTED ||
+           data == LINK_CABLE_ESCAPE;
+  }
+
+  u16 escape(u16 data) {
+    return data == LINK_CABLE_NO_DATA         ? LINK_CABLE_ESCAPED_NO_DATA
+           : data == LINK_CABLE_DISCONNECTED ? LINK_CABLE_ESCAPED_DISCONNECTED
+                                             : LINK_CABLE_ESCAPED_ESCAPE;
+  }
+
+  u16 unescape(u16 data) {
+    return data == LINK_CABLE_ESCAPED_NO_DATA         ? LINK_CABLE_NO_DATA
+           : data == LINK_CABLE_ESCAPED_DISCONNECTED ? LINK_CABLE_DISCONNECTED
+           : data == LINK_CABLE_ESCAPED_ESCAPE       ? LINK_CABLE_ESCAPE
+                                                     : data;
   }
 
   bool resetIfNeeded() {
     if (!isReady() || hasError()) {
+      LINK_CABLE_STATS(_stats.stats.resetsByError++);
       reset();
       return true;
     }
@@ -335,21 +1310,46 @@ class LinkCable {
   }
 
   void resetState() {
-    state.playerCount = 0;
-    state.currentPlayerId = 0;
-    for (u32 i = 0; i < LINK_CABLE_MAX_PLAYERS; i++) {
-      state.incomingMessages[i].clear();
+    state->playerCount = 0;
+    state->currentPlayerId = 0;
+    for (u32 i = 0; i < Config::MAX_PLAYERS; i++) {
+      if constexpr (!Config::RELIABLE)
+        state->incomingMessages[i].clear();
       _state.timeouts[i] = LINK_CABLE_REMOTE_TIMEOUT_OFFLINE;
+      _state.isEscaping[i] = false;
     }
     _state.IRQFlag = false;
     _state.IRQTimeout = 0;
+    _state.burstTransfers = 0;
+    _state.isBursting = false;
+
+    if constexpr (Config::ADAPTIVE_INTERVAL) {
+      // (the transfer time is measured again after each reset)
+      _state.adaptive = AdaptiveState{};
+      _state.adaptive.interval = config.interval;
+      _state.adaptive.minInterval = config.interval;
+    }
 
-    if (isAddingMessage || isResetting)
-      isResetting = true;
-    else
+    if constexpr (Config::RELIABLE) {
+      // (keep the messages and retransmit everything that wasn't acked)
+      ReliableState& reliable = _state.reliable;
+      goBack();
+      reliable.extraWordCount = 0;
+      for (u32 i = 0; i < Config::MAX_PLAYERS; i++) {
+        reliable.hasAcked[i] = false;
+        unsyncReliableReceiver(reliable.receivers[i]);
+      }
+    } else
       _state.outgoingMessages.clear();
   }
 
+  void clearMessages() {
+    for (u32 i = 0; i < Config::MAX_PLAYERS; i++)
+      state->incomingMessages[i].clear();
+    _state.outgoingMessages.clear();
+    _state.reliable = ReliableState{};
+  }
+
   void stop() {
     stopTimer();
 
@@ -358,37 +1358,41 @@ class LinkCable {
   }
 
   void start() {
-    startTimer();
+    startTimer(sendInterval());
 
     LINK_CABLE_SET_LOW(REG_RCNT, LINK_CABLE_BIT_GENERAL_PURPOSE_HIGH);
-    REG_SIOCNT = config.baudRate;
+    REG_SIOCNT = baudRate();
     REG_SIOMLT_SEND = 0;
     setBitHigh(LINK_CABLE_BIT_MULTIPLAYER);
     setBitHigh(LINK_CABLE_BIT_IRQ);
   }
 
   void stopTimer() {
-    REG_TM[config.sendTimerId].cnt =
-        REG_TM[config.sendTimerId].cnt & (~TM_ENABLE);
+    REG_TM[sendTimerId()].cnt =
+        REG_TM[sendTimerId()].cnt & (~TM_ENABLE);
   }
 
-  void startTimer() {
-    REG_TM[config.sendTimerId].start = -config.interval;
-    REG_TM[config.sendTimerId].cnt =
+  void startTimer(u32 interval) {
+    REG_TM[sendTimerId()].start = -interval;
+    REG_TM[sendTimerId()].cnt =
         TM_ENABLE | TM_IRQ | LINK_CABLE_BASE_FREQUENCY;
   }
 
-  void copyState() {
+  LINK_CABLE_IWRAM_CODE void copyState() {
     if (isStateReady && !isStateConsumed)
       return;
 
     LINK_CABLE_BARRIER;
-    $state.playerCount = state.playerCount;
-    $state.currentPlayerId = state.currentPlayerId;
-    for (u32 i = 0; i < LINK_CABLE_MAX_PLAYERS; i++) {
-      $state.incomingMessages[i].clear();
-      while (!state.incomingMessages[i].isEmpty())
-        $state.incomingMessages[i].push(state.incomingMessages[i].pop());
+    ExternalState* updatedState = state;
+    state = $state;
+    $state = updatedState;
+
+    state->playerCount = $state->playerCount;
+    state->currentPlayerId = $state->currentPlayerId;
+    for (u32 i = 0; i < Config::MAX_PLAYERS; i++) {
+      LINK_CABLE_STATS(_stats.stats.droppedIncomingMessages +=
+                       state->incomingMessages[i].size());
+      state->incomingMessages[i].clear();
     }
     LINK_CABLE_BARRIER;
     isStateReady = true;
@@ -401,18 +1405,39 @@ class LinkCable {
   void setBitLow(u8 bit) { LINK_CABLE_SET_LOW(REG_SIOCNT, bit); }
 };
 
+using LinkCable = LinkCableT<>;
+
 extern LinkCable* linkCable;
 
+#if LINK_CABLE_PUT_ISR_IN_IWRAM
+// (LinkCable.iwram.cpp defines `linked` for its own options and class size, so
+//  compiling it with other LINK_CABLE_* options than the rest of the program
+//  fails to link, instead of breaking the ISRs at runtime)
+#define LINK_CABLE_IWRAM_OPTIONS \
+  ((!!LINK_CABLE_ENABLE_STATS << 0) | (!!LINK_CABLE_ENABLE_PROFILER << 1))
+
+template <u32 SIZE, u32 OPTIONS>
+struct LinkCableIWRAMCheck {
+  static const u32 linked;
+};
+
+using LinkCableIWRAMConfig =
+    LinkCableIWRAMCheck<sizeof(LinkCable), LINK_CABLE_IWRAM_OPTIONS>;
+
+__attribute__((used)) static const u32* LINK_CABLE_IWRAM_CHECK =
+    &LinkCableIWRAMConfig::linked;
+#else
 inline void LINK_CABLE_ISR_VBLANK() {
-  linkCable->_onVBlank();
+  LINK_CABLE_PROFILE(CABLE_VBLANK, linkCable->_onVBlank());
 }
 
 inline void LINK_CABLE_ISR_SERIAL() {
-  linkCable->_onSerial();
+  LINK_CABLE_PROFILE(CABLE_SERIAL, linkCable->_onSerial());
 }
 
 inline void LINK_CABLE_ISR_TIMER() {
-  linkCable->_onTimer();
+  LINK_CABLE_PROFILE(CABLE_TIMER, linkCable->_onTimer());
 }
+#endif
 
 #endif  // LINK_CABLE_H
@@ -0,0 +1,37 @@
+// --------------------------------------------------------------------------
+// LinkCable's interrupt service routines, compiled as ARM code in IWRAM.
+// --------------------------------------------------------------------------
+// This file is only used when LINK_CABLE_PUT_ISR_IN_IWRAM is 1 (see
+// LinkCable.h). The examples' Makefile compiles `*.iwram.cpp` files with
+// `-marm -mlong-calls` and links them in IWRAM, so the ISRs run without
+// ROM wait states (the methods they call are marked with
+// LINK_CABLE_IWRAM_CODE). Otherwise, it compiles to nothing.
+// --------------------------------------------------------------------------
+
+#include "LinkCable.h"
+
+#if LINK_CABLE_PUT_ISR_IN_IWRAM
+
+// (weak, so programs that only use `LinkCable::ISR<instance>` don't need to
+//  define the global `linkCable` pointer)
+#pragma weak linkCable
+
+// (see `LinkCableIWRAMCheck` in LinkCable.h)
+template <u32 SIZE, u32 OPTIONS>
+const u32 LinkCableIWRAMCheck<SIZE, OPTIONS>::linked = 1;
+template struct LinkCableIWRAMCheck<sizeof(LinkCable),
+                                    LINK_CABLE_IWRAM_OPTIONS>;
+
+void LINK_CABLE_ISR_VBLANK() {
+  LINK_CABLE_PROFILE(CABLE_VBLANK, linkCable->_onVBlank());
+}
+
+void LINK_CABLE_ISR_SERIAL() {
+  LINK_CABLE_PROFILE(CABLE_SERIAL, linkCable->_onSerial());
+}
+
+void LINK_CABLE_ISR_TIMER() {
+  LINK_CABLE_PROFILE(CABLE_TIMER, linkCable->_onTimer());
+}
+
+#endif
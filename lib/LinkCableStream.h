@@ -0,0 +1,385 @@
+#ifndef LINK_CABLE_STREAM_H
+#define LINK_CABLE_STREAM_H
+
+// --------------------------------------------------------------------------
+// A packet layer on top of LinkCable, for sending large buffers.
+// --------------------------------------------------------------------------
+// Usage:
+// - 1) Include this header in your main.cpp file and add:
+//       LinkCable* linkCable = new LinkCable(LinkCable::BaudRate::BAUD_RATE_3);
+//       LinkCableStream* linkCableStream = new LinkCableStream(linkCable);
+// - 2) Set up LinkCable as usual (ISRs + `activate()`)
+// - 3) Provide a buffer for each player you want to receive from:
+//       u8 levelData[4096];
+//       linkCableStream->setReceiveBuffer(1, levelData, 4096);
+// - 4) Send a buffer to all players:
+//       linkCableStream->send(saveData, saveDataSize);
+//       // (the buffer must stay alive until `isSending()` returns false)
+// - 5) Update the stream once per frame, before `linkCable->consume()`:
+//       linkCableStream->update();
+//       if (linkCableStream->getState(1) == LinkCableStream::COMPLETED) {
+//         u32 size = linkCableStream->receivedBytes(1);
+//         // ...
+//       }
+// --------------------------------------------------------------------------
+// considerations:
+// - the stream reads all the incoming messages, so don't call `read(...)`!
+// - packets are not retransmitted: a lost word makes the packet FAILED
+// - after COMPLETED, words from that player are kept in a small backlog
+//   (LINK_CABLE_STREAM_BACKLOG_SIZE) until the next `setReceiveBuffer(...)`
+//   call, so call it as soon as possible (if the backlog overflows, the next
+//   packet is FAILED)
+// - `update()` refills the outgoing queue once per call, so a packet moves
+//   at most Config::QUEUE_SIZE words per frame: with short send intervals,
+//   use a custom `LinkCableT<Config>` with a bigger QUEUE_SIZE (the benchmark
+//   gets 61 bytes/frame at interval 6 with 32, and 88 with 128)
+// - each transfer carries one word, and intervals shorter than a transfer
+//   skip every other one (e.g. interval 5 at 115200 bps, for 2 players)
+// --------------------------------------------------------------------------
+// Wire format (16-bit words, little endian bytes):
+//   [ESC START] [size] [data...] [ESC SYNC|n]? [data...] [ESC END] [checksum]
+// - a SYNC control word is sent every LINK_CABLE_STREAM_CHUNK_SIZE data words
+// - 0x0000, 0xFFFF and ESC (0xFFFE) are sent as [ESC code]
+// --------------------------------------------------------------------------
+
+#include <tonc_core.h>
+
+#include "LinkCable.h"
+
+#define LINK_CABLE_STREAM_MAX_SIZE 0xFFFF
+#define LINK_CABLE_STREAM_CHUNK_SIZE 64
+#define LINK_CABLE_STREAM_BATCH_SIZE 32
+#define LINK_CABLE_STREAM_BACKLOG_SIZE 64
+#define LINK_CABLE_STREAM_ESCAPE 0xFFFE
+#define LINK_CABLE_STREAM_ESCAPED_NO_DATA 1
+#define LINK_CABLE_STREAM_ESCAPED_DISCONNECTED 2
+#define LINK_CABLE_STREAM_ESCAPED_ESCAPE 3
+#define LINK_CABLE_STREAM_CONTROL_START 0x10
+#define LINK_CABLE_STREAM_CONTROL_END 0x11
+#define LINK_CABLE_STREAM_CONTROL_SYNC 0x100
+
+static volatile char LINK_CABLE_STREAM_VERSION[] = "LinkCableStream/v5.0.2";
+
+template <typename Cable = LinkCable>
+class LinkCableStreamT {
+ public:
+  enum State { IDLE, RECEIVING, COMPLETED, FAILED };
+
+  explicit LinkCableStreamT(Cable* linkCable) { this->linkCable = linkCable; }
+
+  bool send(const u8* data, u32 size) {
+    if (isSending() || size == 0 || size > LINK_CABLE_STREAM_MAX_SIZE)
+      return false;
+
+    outgoing = Outgoing{};
+    outgoing.data = data;
+    outgoing.size = size;
+    outgoing.phase = OutgoingPhase::HEADER;
+
+    return true;
+  }
+
+  bool isSending() {
+    return outgoing.phase != OutgoingPhase::DONE ||
+           outgoing.pendingStart < outgoing.pendingCount;
+  }
+
+  u32 sentBytes() { return outgoing.sentBytes; }
+  u32 totalBytes() { return outgoing.size; }
+
+  void setReceiveBuffer(u8 playerId, u8* buffer, u32 maxSize) {
+    if (playerId >= Cable::MAX_PLAYERS)
+      return;
+
+    Incoming& incoming = incomings[playerId];
+    bool isEscaping = incoming.isEscaping;
+
+    incoming = Incoming{};
+    incoming.buffer = buffer;
+    incoming.maxSize = maxSize;
+    incoming.isEscaping = isEscaping;
+
+    Backlog& backlog = backlogs[playerId];
+    u32 count = backlog.count;
+    bool didOverflow = backlog.didOverflow;
+    backlog.count = 0;
+    backlog.didOverflow = false;
+    for (u32 i = 0; i < count; i++)
+      process(playerId, backlog.words[i]);
+
+    // (the words that didn't fit belong to the packet that follows the
+    //  backlog, so it can't be completed)
+    if (didOverflow) {
+      if (incoming.state == State::COMPLETED)
+        backlog.didOverflow = true;
+      else
+        fail(incoming);
+    }
+  }
+
+  State getState(u8 playerId) {
+    return playerId < Cable::MAX_PLAYERS ? incomings[playerId].state
+                                         : State::IDLE;
+  }
+  u32 receivedBytes(u8 playerId) {
+    return playerId < Cable::MAX_PLAYERS ? incomings[playerId].receivedBytes
+                                         : 0;
+  }
+  u32 expectedBytes(u8 playerId) {
+    return playerId < Cable::MAX_PLAYERS ? incomings[playerId].size : 0;
+  }
+
+  void update() {
+    flush();
+
+    for (u32 i = 0; i < Cable::MAX_PLAYERS; i++) {
+      u16 words[LINK_CABLE_STREAM_BATCH_SIZE];
+      u32 count;
+      while ((count = linkCable->readAll(i, words,
+                                         LINK_CABLE_STREAM_BATCH_SIZE)) > 0) {
+        for (u32 j = 0; j < count; j++)
+          process(i, words[j]);
+      }
+
+      if (incomings[i].state == RECEIVING && i >= linkCable->playerCount())
+        fail(incomings[i]);
+    }
+  }
+
+ private:
+  enum OutgoingPhase { DONE, HEADER, DATA, FOOTER };
+  enum IncomingPhase {
+    WAITING_START,
+    WAITING_SIZE,
+    WAITING_DATA,
+    WAITING_CHECKSUM
+  };
+
+  struct Outgoing {
+    const u8* data = NULL;
+    u32 size = 0;
+    u32 sentBytes = 0;
+    u32 wordsSinceSync = 0;
+    u8 syncId = 0;
+    u16 checksum = 0;
+    OutgoingPhase phase = OutgoingPhase::DONE;
+    u16 pending[LINK_CABLE_STREAM_BATCH_SIZE];
+    u32 pendingStart = 0;
+    u32 pendingCount = 0;
+  };
+
+  struct Incoming {
+    u8* buffer = NULL;
+    u32 maxSize = 0;
+    u32 size = 0;
+    u32 receivedBytes = 0;
+    u32 wordsSinceSync = 0;
+    u8 syncId = 0;
+    u16 checksum = 0;
+    IncomingPhase phase = IncomingPhase::WAITING_START;
+    State state = State::IDLE;
+    bool isEscaping = false;
+  };
+
+  struct Backlog {
+    u16 words[LINK_CABLE_STREAM_BACKLOG_SIZE];
+    u32 count = 0;
+    bool didOverflow = false;
+  };
+
+  Cable* linkCable;
+  Outgoing outgoing;
+  Incoming incomings[Cable::MAX_PLAYERS];
+  Backlog backlogs[Cable::MAX_PLAYERS];
+
+  void flush() {
+    while (true) {
+      if (outgoing.pendingStart == outgoing.pendingCount && !encode())
+        return;
+
+      outgoing.pendingStart +=
+          linkCable->send(outgoing.pending + outgoing.pendingStart,
+                          outgoing.pendingCount - outgoing.pendingStart);
+      if (outgoing.pendingStart < outgoing.pendingCount)
+        return;
+    }
+  }
+
+  bool encode() {
+    if (outgoing.phase == OutgoingPhase::DONE)
+      return false;
+
+    outgoing.pendingStart = 0;
+    outgoing.pendingCount = 0;
+
+    // (each step adds up to 4 words: [ESC SYNC|n] [ESC code])
+    while (outgoing.phase != OutgoingPhase::DONE &&
+           outgoing.pendingCount + 4 <= LINK_CABLE_STREAM_BATCH_SIZE) {
+      switch (outgoing.phase) {
+        case OutgoingPhase::HEADER: {
+          addControl(LINK_CABLE_STREAM_CONTROL_START);
+          addData(outgoing.size);
+          outgoing.phase = OutgoingPhase::DATA;
+          break;
+        }
+        case OutgoingPhase::DATA: {
+          if (outgoing.wordsSinceSync == LINK_CABLE_STREAM_CHUNK_SIZE) {
+            addControl(LINK_CABLE_STREAM_CONTROL_SYNC | outgoing.syncId++);
+            outgoing.wordsSinceSync = 0;
+          }
+
+          u32 i = outgoing.sentBytes;
+          u16 word = outgoing.data[i];
+          if (i + 1 < outgoing.size)
+            word |= outgoing.data[i + 1] << 8;
+          addData(word);
+          outgoing.checksum += word;
+          outgoing.wordsSinceSync++;
+          outgoing.sentBytes = i + 2 < outgoing.size ? i + 2 : outgoing.size;
+
+          if (outgoing.sentBytes == outgoing.size)
+            outgoing.phase = OutgoingPhase::FOOTER;
+          break;
+        }
+        case OutgoingPhase::FOOTER: {
+          addControl(LINK_CABLE_STREAM_CONTROL_END);
+          addData(outgoing.checksum);
+          outgoing.phase = OutgoingPhase::DONE;
+          break;
+        }
+        default: {
+        }
+      }
+    }
+
+    return outgoing.pendingCount > 0;
+  }
+
+  void addControl(u16 code) {
+    outgoing.pending[outgoing.pendingCount++] = LINK_CABLE_STREAM_ESCAPE;
+    outgoing.pending[outgoing.pendingCount++] = code;
+  }
+
+  void addData(u16 word) {
+    if (word == LINK_CABLE_NO_DATA)
+      addControl(LINK_CABLE_STREAM_ESCAPED_NO_DATA);
+    else if (word == LINK_CABLE_DISCONNECTED)
+      addControl(LINK_CABLE_STREAM_ESCAPED_DISCONNECTED);
+    else if (word == LINK_CABLE_STREAM_ESCAPE)
+      addControl(LINK_CABLE_STREAM_ESCAPED_ESCAPE);
+    else
+      outgoing.pending[outgoing.pendingCount++] = word;
+  }
+
+  void process(u8 playerId, u16 word) {
+    if (incomings[playerId].state == State::COMPLETED) {
+      Backlog& backlog = backlogs[playerId];
+      if (backlog.count < LINK_CABLE_STREAM_BACKLOG_SIZE)
+        backlog.words[backlog.count++] = word;
+      else
+        backlog.didOverflow = true;
+    } else
+      receive(incomings[playerId], word);
+  }
+
+  void receive(Incoming& incoming, u16 word) {
+    if (incoming.isEscaping) {
+      incoming.isEscaping = false;
+
+      if (word == LINK_CABLE_STREAM_ESCAPED_NO_DATA)
+        onData(incoming, LINK_CABLE_NO_DATA);
+      else if (word == LINK_CABLE_STREAM_ESCAPED_DISCONNECTED)
+        onData(incoming, LINK_CABLE_DISCONNECTED);
+      else if (word == LINK_CABLE_STREAM_ESCAPED_ESCAPE)
+        onData(incoming, LINK_CABLE_STREAM_ESCAPE);
+      else
+        onControl(incoming, word);
+    } else if (word == LINK_CABLE_STREAM_ESCAPE)
+      incoming.isEscaping = true;
+    else
+      onData(incoming, word);
+  }
+
+  void onControl(Incoming& incoming, u16 code) {
+    if (incoming.buffer == NULL)
+      return;
+
+    if (code != LINK_CABLE_STREAM_CONTROL_START &&
+        incoming.state != State::RECEIVING)
+      return;
+
+    if (code == LINK_CABLE_STREAM_CONTROL_START) {
+      incoming.size = 0;
+      incoming.receivedBytes = 0;
+      incoming.wordsSinceSync = 0;
+      incoming.syncId = 0;
+      incoming.checksum = 0;
+      incoming.phase = IncomingPhase::WAITING_SIZE;
+      incoming.state = State::RECEIVING;
+    } else if (incoming.phase != IncomingPhase::WAITING_DATA)
+      fail(incoming);
+    else if ((code & ~0xff) == LINK_CABLE_STREAM_CONTROL_SYNC) {
+      if (incoming.wordsSinceSync != LINK_CABLE_STREAM_CHUNK_SIZE ||
+          (code & 0xff) != incoming.syncId)
+        return fail(incoming);
+
+      incoming.wordsSinceSync = 0;
+      incoming.syncId++;
+    } else if (code == LINK_CABLE_STREAM_CONTROL_END) {
+      if (incoming.receivedBytes != incoming.size)
+        return fail(incoming);
+
+      incoming.phase = IncomingPhase::WAITING_CHECKSUM;
+    } else
+      fail(incoming);
+  }
+
+  void onData(Incoming& incoming, u16 word) {
+    if (incoming.buffer == NULL || incoming.state != State::RECEIVING)
+      return;
+
+    switch (incoming.phase) {
+      case IncomingPhase::WAITING_SIZE: {
+        if (word == 0 || word > incoming.maxSize)
+          return fail(incoming);
+
+        incoming.size = word;
+        incoming.phase = IncomingPhase::WAITING_DATA;
+        break;
+      }
+      case IncomingPhase::WAITING_DATA: {
+        if (incoming.wordsSinceSync == LINK_CABLE_STREAM_CHUNK_SIZE ||
+            incoming.receivedBytes == incoming.size)
+          return fail(incoming);
+
+        u32 i = incoming.receivedBytes;
+        incoming.buffer[i] = word & 0xff;
+        if (i + 1 < incoming.size)
+          incoming.buffer[i + 1] = word >> 8;
+        incoming.receivedBytes = i + 2 < incoming.size ? i + 2 : incoming.size;
+        incoming.checksum += word;
+        incoming.wordsSinceSync++;
+        break;
+      }
+      case IncomingPhase::WAITING_CHECKSUM: {
+        if (word != incoming.checksum)
+          return fail(incoming);
+
+        incoming.phase = IncomingPhase::WAITING_START;
+        incoming.state = State::COMPLETED;
+        break;
+      }
+      default: {
+      }
+    }
+  }
+
+  void fail(Incoming& incoming) {
+    incoming.phase = IncomingPhase::WAITING_START;
+    incoming.state = State::FAILED;
+  }
+};
+
+using LinkCableStream = LinkCableStreamT<>;
+
+#endif  // LINK_CABLE_STREAM_H
@@ -0,0 +1,162 @@
+#ifndef LINK_PROFILER_H
+#define LINK_PROFILER_H
+
+// --------------------------------------------------------------------------
+// A cycle counter for interrupt service routines, using two cascaded timers.
+// --------------------------------------------------------------------------
+// Usage:
+// - 1) Enable the hooks of the libraries you want to measure:
+//       #define LINK_CABLE_ENABLE_PROFILER 1
+//       #define LINK_WIRELESS_ENABLE_PROFILER 1
+//       // (before including LinkCable.h / LinkWireless.h)
+// - 2) Include this header in your main.cpp file and add:
+//       LinkProfiler* linkProfiler = new LinkProfiler();
+// - 3) Initialize the library with:
+//       linkProfiler->activate();
+//       // (the LINK_CABLE_ISR_* / LINK_WIRELESS_ISR_* functions will report
+//       //  how many cycles `_onVBlank()`, `_onSerial()` and `_onTimer()` take)
+// - 4) Read the results:
+//       LinkProfiler::Stats stats =
+//         linkProfiler->getStats(LinkProfiler::Handler::CABLE_SERIAL);
+//       // (count, min/avg/max cycles and a histogram)
+// - 5) (Optional) Measure your own handlers:
+//       linkProfiler->profile(LinkProfiler::Handler::CUSTOM_0,
+//                             []() { myHandler(); });
+// --------------------------------------------------------------------------
+// considerations:
+// - it uses two timers (`timerId` and `timerId + 1`), so they can't be used
+//   by other libraries (e.g. don't use timer 0 or 1 as the send timer)
+// - the measured time includes nested interrupts, if they're enabled
+// - the cost of reading the timers is subtracted from every sample
+// - histogram buckets are powers of two: bucket #i counts samples that took
+//   [2^i, 2^(i+1)) cycles (#0 also counts 0 cycles, and the last one counts
+//   everything above)
+// - on the host simulator (lib/host), time only advances on I/O accesses,
+//   so the results show the I/O cost of each handler (see LinkHostBus.h)
+// --------------------------------------------------------------------------
+
+#include <tonc_core.h>
+
+#define LINK_PROFILER_MAX_HANDLERS 8
+#define LINK_PROFILER_HISTOGRAM_BUCKETS 16
+#define LINK_PROFILER_DEFAULT_TIMER_ID 0
+#define LINK_PROFILER_FREQUENCY TM_FREQ_1
+
+static volatile char LINK_PROFILER_VERSION[] = "LinkProfiler/v5.0.2";
+
+class LinkProfiler {
+ public:
+  enum Handler {
+    CABLE_VBLANK,
+    CABLE_SERIAL,
+    CABLE_TIMER,
+    WIRELESS_VBLANK,
+    WIRELESS_SERIAL,
+    WIRELESS_TIMER,
+    CUSTOM_0,
+    CUSTOM_1
+  };
+
+  struct Stats {
+    u32 count = 0;
+    u32 min = 0;
+    u32 avg = 0;
+    u32 max = 0;
+    u64 total = 0;
+    u32 histogram[LINK_PROFILER_HISTOGRAM_BUCKETS] = {};
+  };
+
+  explicit LinkProfiler(u8 timerId = LINK_PROFILER_DEFAULT_TIMER_ID) {
+    this->config.timerId = timerId < 3 ? timerId : 2;
+  }
+
+  bool isActive() { return isEnabled; }
+
+  void activate() {
+    isEnabled = false;
+    reset();
+
+    REG_TM[config.timerId].cnt = 0;
+    REG_TM[config.timerId + 1].cnt = 0;
+    REG_TM[config.timerId].start = 0;
+    REG_TM[config.timerId + 1].start = 0;
+    REG_TM[config.timerId + 1].cnt = TM_ENABLE | TM_CASCADE;
+    REG_TM[config.timerId].cnt = TM_ENABLE | LINK_PROFILER_FREQUENCY;
+
+    u32 start = now();
+    overhead = now() - start;
+
+    isEnabled = true;
+  }
+
+  void deactivate() {
+    isEnabled = false;
+
+    REG_TM[config.timerId].cnt = 0;
+    REG_TM[config.timerId + 1].cnt = 0;
+  }
+
+  void reset() {
+    for (u32 i = 0; i < LINK_PROFILER_MAX_HANDLERS; i++)
+      entries[i] = Stats{};
+  }
+
+  Stats getStats(Handler handler) {
+    Stats stats = entries[handler];
+    if (stats.count > 0)
+      stats.avg = stats.total / stats.count;
+    return stats;
+  }
+
+  template <typename F>
+  void profile(Handler handler, F action) {
+    if (!isEnabled)
+      return action();
+
+    u32 start = now();
+    action();
+    record(handler, now() - start);
+  }
+
+  u32 now() {
+    u16 high = REG_TM[config.timerId + 1].count;
+    u16 low = REG_TM[config.timerId].count;
+    u16 newHigh = REG_TM[config.timerId + 1].count;
+
+    if (newHigh != high)
+      low = REG_TM[config.timerId].count;
+
+    return (newHigh << 16) | low;
+  }
+
+ private:
+  struct Config {
+    u8 timerId;
+  };
+
+  Stats entries[LINK_PROFILER_MAX_HANDLERS];
+  Config config;
+  u32 overhead = 0;
+  bool isEnabled = false;
+
+  void record(Handler handler, u32 cycles) {
+    Stats& stats = entries[handler];
+    cycles = cycles > overhead ? cycles - overhead : 0;
+
+    if (stats.count == 0 || cycles < stats.min)
+      stats.min = cycles;
+    if (cycles > stats.max)
+      stats.max = cycles;
+    stats.total += cycles;
+    stats.count++;
+
+    u32 bucket = 31 - __builtin_clz(cycles | 1);
+    if (bucket >= LINK_PROFILER_HISTOGRAM_BUCKETS)
+      bucket = LINK_PROFILER_HISTOGRAM_BUCKETS - 1;
+    stats.histogram[bucket]++;
+  }
+};
+
+extern LinkProfiler* linkProfiler;
+
+#endif  // LINK_PROFILER_H
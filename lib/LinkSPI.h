@@ -11,6 +11,8 @@
 //       irq_init(NULL);
 //       irq_add(II_SERIAL, LINK_SPI_ISR_SERIAL);
 //       // (this is only required for `transferAsync`)
+//       // (or, to avoid the global pointer, use a static instance:
+//       //  `LinkSPI myLinkSPI;` + `LinkSPI::ISR<myLinkSPI>::SERIAL`)
 // - 3) Initialize the library with:
 //       linkSPI->activate(LinkSPI::Mode::MASTER_256KBPS);
 //       // (use LinkSPI::Mode::SLAVE on the other end)
@@ -183,6 +185,13 @@ class LinkSPI {
     asyncData = getData();
   }
 
+  // (interrupt service routine bound to an instance with static storage,
+  //  so it doesn't read a global pointer)
+  template <LinkSPI& instance>
+  struct ISR {
+    static void SERIAL() { instance._onSerial(); }
+  };
+
   void _setSOHigh() { setBitHigh(LINK_SPI_BIT_SO); }
   void _setSOLow() { setBitLow(LINK_SPI_BIT_SO); }
   bool _isSIHigh() { return isBitHigh(LINK_SPI_BIT_SI); }
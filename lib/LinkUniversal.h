@@ -12,6 +12,11 @@
 //       irq_add(II_VBLANK, LINK_UNIVERSAL_ISR_VBLANK);
 //       irq_add(II_SERIAL, LINK_UNIVERSAL_ISR_SERIAL);
 //       irq_add(II_TIMER3, LINK_UNIVERSAL_ISR_TIMER);
+// - 2b) Or, to avoid the global pointer, use a static instance:
+//       LinkUniversal myLinkUniversal;
+//       irq_add(II_VBLANK, LinkUniversal::ISR<myLinkUniversal>::VBLANK);
+//       irq_add(II_SERIAL, LinkUniversal::ISR<myLinkUniversal>::SERIAL);
+//       irq_add(II_TIMER3, LinkUniversal::ISR<myLinkUniversal>::TIMER);
 // - 3) Initialize the library with:
 //       linkUniversal->activate();
 // - 4) Sync:
@@ -26,6 +31,11 @@
 //         u16 message = linkUniversal->read(!currentPlayerId);
 //         // ...
 //       }
+// - 6) (Optional) Read the statistics counters:
+//       LinkUniversal::Stats stats = linkUniversal->getStats();
+//       // (requires LINK_UNIVERSAL_ENABLE_STATS, and also
+//       //  LINK_CABLE_ENABLE_STATS / LINK_WIRELESS_ENABLE_STATS
+//       //  for the `cable` and `wireless` fields)
 // --------------------------------------------------------------------------
 // (*) libtonc's interrupt handler sometimes ignores interrupts due to a bug.
 //     That can cause packet loss. You might want to use libugba's instead.
@@ -40,6 +50,11 @@
 #include "LinkCable.h"
 #include "LinkWireless.h"
 
+// Statistics counters (0 = disabled, 1 = enabled)
+#ifndef LINK_UNIVERSAL_ENABLE_STATS
+#define LINK_UNIVERSAL_ENABLE_STATS 0
+#endif
+
 #define LINK_UNIVERSAL_MAX_PLAYERS LINK_CABLE_MAX_PLAYERS
 #define LINK_UNIVERSAL_DISCONNECTED LINK_CABLE_DISCONNECTED
 #define LINK_UNIVERSAL_NO_DATA LINK_CABLE_NO_DATA
@@ -51,6 +66,12 @@
 #define LINK_UNIVERSAL_SERVE_WAIT_FRAMES 60
 #define LINK_UNIVERSAL_SERVE_WAIT_FRAMES_RANDOM 30
 
+#if LINK_UNIVERSAL_ENABLE_STATS
+#define LINK_UNIVERSAL_STATS(...) __VA_ARGS__
+#else
+#define LINK_UNIVERSAL_STATS(...)
+#endif
+
 static volatile char LINK_UNIVERSAL_VERSION[] = "LinkUniversal/v5.0.2";
 
 void LINK_UNIVERSAL_ISR_VBLANK();
@@ -80,9 +101,26 @@ class LinkUniversal {
     u8 sendTimerId;
   };
 
+  // (all counters start at zero on `activate()`)
+  struct Stats {
+    u32 sentMessages = 0;             // (accepted by the current driver)
+    u32 receivedMessages = 0;         // (moved to the incoming queues)
+    u32 droppedOutgoingMessages = 0;  // (rejected by the current driver)
+    u32 droppedIncomingMessages = 0;  // (full incoming queue)
+    u32 modeSwitches = 0;
+    u32 disconnections = 0;  // (CONNECTED -> INITIALIZING)
+    u32 incomingQueueHighWaterMark = 0;
+    LinkCable::Stats cable;        // (see LINK_CABLE_ENABLE_STATS)
+    LinkWireless::Stats wireless;  // (see LINK_WIRELESS_ENABLE_STATS)
+  };
+
   explicit LinkUniversal(
       Protocol protocol = AUTODETECT,
+#if LINK_WIRELESS_USE_STD_STRING
       std::string gameName = "",
+#else
+      const char* gameName = "",
+#endif
       CableOptions cableOptions =
           CableOptions{
               LinkCable::BaudRate::BAUD_RATE_1, LINK_CABLE_DEFAULT_TIMEOUT,
@@ -91,22 +129,31 @@ class LinkUniversal {
       WirelessOptions wirelessOptions = WirelessOptions{
           true, LINK_WIRELESS_MAX_PLAYERS, LINK_WIRELESS_DEFAULT_TIMEOUT,
           LINK_WIRELESS_DEFAULT_REMOTE_TIMEOUT, LINK_WIRELESS_DEFAULT_INTERVAL,
-          LINK_WIRELESS_DEFAULT_SEND_TIMER_ID}) {
-    this->linkCable = new LinkCable(
-        cableOptions.baudRate, cableOptions.timeout, cableOptions.remoteTimeout,
-        cableOptions.interval, cableOptions.sendTimerId);
-    this->linkWireless = new LinkWireless(
-        wirelessOptions.retransmission, true, wirelessOptions.maxPlayers,
-        wirelessOptions.timeout, wirelessOptions.remoteTimeout,
-        wirelessOptions.interval, wirelessOptions.sendTimerId);
-
+          LINK_WIRELESS_DEFAULT_SEND_TIMER_ID})
+      : linkCable(cableOptions.baudRate,
+                  cableOptions.timeout,
+                  cableOptions.remoteTimeout,
+                  cableOptions.interval,
+                  cableOptions.sendTimerId),
+        linkWireless(wirelessOptions.retransmission,
+                     true,
+                     wirelessOptions.maxPlayers,
+                     wirelessOptions.timeout,
+                     wirelessOptions.remoteTimeout,
+                     wirelessOptions.interval,
+                     wirelessOptions.sendTimerId) {
     this->config.protocol = protocol;
-    this->config.gameName = gameName;
+#if LINK_WIRELESS_USE_STD_STRING
+    copyGameName(gameName.c_str());
+#else
+    copyGameName(gameName);
+#endif
   }
 
   bool isActive() { return isEnabled; }
 
   void activate() {
+    LINK_UNIVERSAL_STATS(stats = Stats{});
     reset();
     isEnabled = true;
   }
@@ -114,8 +161,8 @@ class LinkUniversal {
   void deactivate() {
     isEnabled = false;
 
-    linkCable->deactivate();
-    linkWireless->deactivate();
+    linkCable.deactivate();
+    linkWireless.deactivate();
   }
 
   void setProtocol(Protocol protocol) { this->config.protocol = protocol; }
@@ -124,13 +171,13 @@ class LinkUniversal {
   bool isConnected() { return state == CONNECTED; }
 
   u8 playerCount() {
-    return mode == LINK_CABLE ? linkCable->playerCount()
-                              : linkWireless->playerCount();
+    return mode == LINK_CABLE ? linkCable.playerCount()
+                              : linkWireless.playerCount();
   }
 
   u8 currentPlayerId() {
-    return mode == LINK_CABLE ? linkCable->currentPlayerId()
-                              : linkWireless->currentPlayerId();
+    return mode == LINK_CABLE ? linkCable.currentPlayerId()
+                              : linkWireless.currentPlayerId();
   }
 
   void sync() {
@@ -180,6 +227,7 @@ class LinkUniversal {
         if (mode == LINK_CABLE) {
           // Cable, connected...
           if (!isConnectedCable()) {
+            LINK_UNIVERSAL_STATS(stats.disconnections++);
             toggleMode();
             break;
           }
@@ -188,6 +236,7 @@ class LinkUniversal {
         } else {
           // Wireless, connected...
           if (!isConnectedWireless()) {
+            LINK_UNIVERSAL_STATS(stats.disconnections++);
             toggleMode();
             break;
           }
@@ -200,7 +249,7 @@ class LinkUniversal {
     }
 
     if (mode == LINK_CABLE)
-      linkCable->consume();
+      linkCable.consume();
   }
 
   bool canRead(u8 playerId) { return !incomingMessages[playerId].isEmpty(); }
@@ -211,54 +260,69 @@ class LinkUniversal {
     if (data == LINK_CABLE_DISCONNECTED || data == LINK_CABLE_NO_DATA)
       return;
 
-    if (mode == LINK_CABLE)
-      linkCable->send(data);
-    else
-      linkWireless->send(data);
+    [[maybe_unused]] bool success = mode == LINK_CABLE
+                                        ? linkCable.send(data)
+                                        : linkWireless.send(data);
+    LINK_UNIVERSAL_STATS(countSentMessage(success));
+  }
+
+  Stats getStats() {
+#if LINK_UNIVERSAL_ENABLE_STATS
+    Stats snapshot = stats;
+    snapshot.cable = linkCable.getStats();
+    snapshot.wireless = linkWireless.getStats();
+    return snapshot;
+#else
+    return Stats{};
+#endif
   }
 
   State getState() { return state; }
   Mode getMode() { return mode; }
-  LinkWireless::State getWirelessState() { return linkWireless->getState(); }
-
-  ~LinkUniversal() {
-    delete linkCable;
-    delete linkWireless;
-  }
+  LinkWireless::State getWirelessState() { return linkWireless.getState(); }
 
   u32 _getWaitCount() { return waitCount; }
   u32 _getSubWaitCount() { return subWaitCount; }
 
   void _onVBlank() {
     if (mode == LINK_CABLE)
-      linkCable->_onVBlank();
+      linkCable._onVBlank();
     else
-      linkWireless->_onVBlank();
+      linkWireless._onVBlank();
   }
 
   void _onSerial() {
     if (mode == LINK_CABLE)
-      linkCable->_onSerial();
+      linkCable._onSerial();
     else
-      linkWireless->_onSerial();
+      linkWireless._onSerial();
   }
 
   void _onTimer() {
     if (mode == LINK_CABLE)
-      linkCable->_onTimer();
+      linkCable._onTimer();
     else
-      linkWireless->_onTimer();
+      linkWireless._onTimer();
   }
 
+  // (interrupt service routines bound to an instance with static storage,
+  //  so they don't read a global pointer)
+  template <LinkUniversal& instance>
+  struct ISR {
+    static void VBLANK() { instance._onVBlank(); }
+    static void SERIAL() { instance._onSerial(); }
+    static void TIMER() { instance._onTimer(); }
+  };
+
  private:
   struct Config {
     Protocol protocol;
-    std::string gameName;
+    char gameName[LINK_WIRELESS_MAX_GAME_NAME_LENGTH + 1];
   };
 
   LinkCable::U16Queue incomingMessages[LINK_UNIVERSAL_MAX_PLAYERS];
-  LinkCable* linkCable;
-  LinkWireless* linkWireless;
+  LinkCable linkCable;
+  LinkWireless linkWireless;
   Config config;
   State state = INITIALIZING;
   Mode mode = LINK_CABLE;
@@ -267,33 +331,65 @@ class LinkUniversal {
   u32 subWaitCount = 0;
   u32 serveWait = 0;
   bool isEnabled = false;
+#if LINK_UNIVERSAL_ENABLE_STATS
+  Stats stats;
+
+  void countSentMessage(bool success) {
+    if (success)
+      stats.sentMessages++;
+    else
+      stats.droppedOutgoingMessages++;
+  }
+
+  void countReceivedMessage(u8 playerId, bool success) {
+    u32 size = incomingMessages[playerId].size();
+    if (success)
+      stats.receivedMessages++;
+    else
+      stats.droppedIncomingMessages++;
+    if (size > stats.incomingQueueHighWaterMark)
+      stats.incomingQueueHighWaterMark = size;
+  }
+#endif
+
+  void pushMessage(u8 playerId, u16 data) {
+    [[maybe_unused]] bool success = incomingMessages[playerId].push(data);
+    LINK_UNIVERSAL_STATS(countReceivedMessage(playerId, success));
+  }
 
   void receiveCableMessages() {
     for (u32 i = 0; i < LINK_UNIVERSAL_MAX_PLAYERS; i++) {
-      while (linkCable->canRead(i))
-        incomingMessages[i].push(linkCable->read(i));
+      while (linkCable.canRead(i))
+        pushMessage(i, linkCable.read(i));
     }
   }
 
   void receiveWirelessMessages() {
     LinkWireless::Message messages[LINK_WIRELESS_MAX_TRANSFER_LENGTH];
-    linkWireless->receive(messages);
+    linkWireless.receive(messages);
 
     for (u32 i = 0; i < LINK_WIRELESS_MAX_TRANSFER_LENGTH; i++) {
       auto message = messages[i];
       if (message.packetId == LINK_WIRELESS_END)
         break;
 
-      incomingMessages[message.playerId].push(message.data);
+      pushMessage(message.playerId, message.data);
     }
   }
 
   bool autoDiscoverWirelessConnections() {
-    switch (linkWireless->getState()) {
-      case LinkWireless::State::NEEDS_RESET:
+    switch (linkWireless.getState()) {
+      case LinkWireless::State::NEEDS_RESET: {
+        // (the adapter is restarted in the background)
+        linkWireless.activateAsync();
+        break;
+      }
+      case LinkWireless::State::AUTHENTICATING: {
+        break;
+      }
       case LinkWireless::State::AUTHENTICATED: {
         subWaitCount = 0;
-        linkWireless->getServersAsyncStart();
+        linkWireless.getServersAsyncStart();
         break;
       }
       case LinkWireless::State::SEARCHING: {
@@ -307,7 +403,7 @@ class LinkUniversal {
         break;
       }
       case LinkWireless::State::CONNECTING: {
-        if (!linkWireless->keepConnecting())
+        if (!linkWireless.keepConnecting())
           return false;
 
         break;
@@ -332,7 +428,7 @@ class LinkUniversal {
 
   bool tryConnectOrServeWirelessSession() {
     LinkWireless::Server servers[LINK_WIRELESS_MAX_SERVERS];
-    if (!linkWireless->getServersAsyncEnd(servers))
+    if (!linkWireless.getServersAsyncEnd(servers))
       return false;
 
     u32 maxRandomNumber = 0;
@@ -342,9 +438,15 @@ class LinkUniversal {
       if (server.id == LINK_WIRELESS_END)
         break;
 
-      u32 randomNumber = std::stoi(server.userName);
+#if LINK_WIRELESS_USE_STD_STRING
+      const char* gameName = server.gameName.c_str();
+      u32 randomNumber = parseRoomNumber(server.userName.c_str());
+#else
+      const char* gameName = server.gameName;
+      u32 randomNumber = parseRoomNumber(server.userName);
+#endif
 
-      if (server.gameName == config.gameName &&
+      if (areNamesEqual(gameName, config.gameName) &&
           randomNumber > maxRandomNumber) {
         maxRandomNumber = randomNumber;
         serverIndex = i;
@@ -352,7 +454,7 @@ class LinkUniversal {
     }
 
     if (maxRandomNumber > 0) {
-      if (!linkWireless->connect(servers[serverIndex].id))
+      if (!linkWireless.connect(servers[serverIndex].id))
         return false;
     } else {
       if (config.protocol == WIRELESS_CLIENT)
@@ -361,16 +463,56 @@ class LinkUniversal {
       subWaitCount = 0;
       serveWait = LINK_UNIVERSAL_SERVE_WAIT_FRAMES +
                   qran_range(1, LINK_UNIVERSAL_SERVE_WAIT_FRAMES_RANDOM);
-      u32 randomNumber = qran_range(1, LINK_UNIVERSAL_MAX_ROOM_NUMBER);
-      if (!linkWireless->serve(config.gameName, std::to_string(randomNumber)))
+      char roomNumber[LINK_WIRELESS_MAX_USER_NAME_LENGTH + 1];
+      formatRoomNumber(qran_range(1, LINK_UNIVERSAL_MAX_ROOM_NUMBER),
+                       roomNumber);
+      if (!linkWireless.serve(config.gameName, roomNumber))
         return false;
     }
 
     return true;
   }
 
-  bool isConnectedCable() { return linkCable->isConnected(); }
-  bool isConnectedWireless() { return linkWireless->isConnected(); }
+  void copyGameName(const char* gameName) {
+    u32 length = 0;
+    while (length < LINK_WIRELESS_MAX_GAME_NAME_LENGTH &&
+           gameName[length] != '\0') {
+      config.gameName[length] = gameName[length];
+      length++;
+    }
+    config.gameName[length] = '\0';
+  }
+
+  bool areNamesEqual(const char* name1, const char* name2) {
+    while (*name1 != '\0' && *name1 == *name2) {
+      name1++;
+      name2++;
+    }
+    return *name1 == *name2;
+  }
+
+  u32 parseRoomNumber(const char* userName) {
+    u32 number = 0;
+    while (*userName >= '0' && *userName <= '9')
+      number = number * 10 + (*userName++ - '0');
+    return number;
+  }
+
+  void formatRoomNumber(u32 number, char* userName) {
+    char digits[LINK_WIRELESS_MAX_USER_NAME_LENGTH];
+    u32 count = 0;
+    do {
+      digits[count++] = '0' + number % 10;
+      number /= 10;
+    } while (number > 0 && count < LINK_WIRELESS_MAX_USER_NAME_LENGTH);
+
+    for (u32 i = 0; i < count; i++)
+      userName[i] = digits[count - 1 - i];
+    userName[count] = '\0';
+  }
+
+  bool isConnectedCable() { return linkCable.isConnected(); }
+  bool isConnectedWireless() { return linkWireless.isConnected(); }
 
   void reset() {
     switch (config.protocol) {
@@ -389,9 +531,9 @@ class LinkUniversal {
 
   void stop() {
     if (mode == LINK_CABLE)
-      linkCable->deactivate();
+      linkCable.deactivate();
     else
-      linkWireless->deactivate();
+      linkWireless.deactivate();
   }
 
   void toggleMode() {
@@ -413,6 +555,7 @@ class LinkUniversal {
   }
 
   void setMode(Mode mode) {
+    LINK_UNIVERSAL_STATS(if (mode != this->mode) stats.modeSwitches++);
     stop();
     this->state = INITIALIZING;
     this->mode = mode;
@@ -421,9 +564,9 @@ class LinkUniversal {
 
   void start() {
     if (mode == LINK_CABLE)
-      linkCable->activate();
+      linkCable.activate();
     else
-      linkWireless->activate();
+      linkWireless.activateAsync();
 
     state = WAITING;
     resetState();
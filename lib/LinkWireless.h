@@ -12,8 +12,16 @@
 //       irq_add(II_VBLANK, LINK_WIRELESS_ISR_VBLANK);
 //       irq_add(II_SERIAL, LINK_WIRELESS_ISR_SERIAL);
 //       irq_add(II_TIMER3, LINK_WIRELESS_ISR_TIMER);
+// - 2b) Or, to avoid the global pointer, use a static instance:
+//       LinkWireless myLinkWireless;
+//       irq_add(II_VBLANK, LinkWireless::ISR<myLinkWireless>::VBLANK);
+//       irq_add(II_SERIAL, LinkWireless::ISR<myLinkWireless>::SERIAL);
+//       irq_add(II_TIMER3, LinkWireless::ISR<myLinkWireless>::TIMER);
 // - 3) Initialize the library with:
 //       linkWireless->activate();
+// - 3b) Or, to avoid blocking while the adapter starts:
+//       linkWireless->activateAsync();
+//       // (`getState()` is AUTHENTICATING until it becomes AUTHENTICATED)
 // - 4) Start a server:
 //       linkWireless->serve();
 //
@@ -32,6 +40,10 @@
 //       // `getState()` should return CONNECTED now...
 //       // `currentPlayerId()` should return 1, 2, 3, or 4 (the host is 0)
 //       // `playerCount()` should return the number of active consoles
+//
+//       // (or, without blocking: `getServersAsyncStart()`, `peekServers(...)`
+//       //  every frame, `getServersAsyncEnd(...)` and then `connect(...)`;
+//       //  the interrupts talk to the adapter)
 // - 6) Send data:
 //       linkWireless->send(0x1234);
 // - 7) Receive data:
@@ -40,9 +52,18 @@
 //       if (messages[0].packetId != LINK_WIRELESS_END) {
 //         // ...
 //       }
+// - 7b) (Optional) Send and receive byte buffers:
+//       linkWireless->send(&myStruct, sizeof(myStruct));
+//       // (after `receive(...)`)
+//       if (linkWireless->canReadBuffer(playerId))
+//         linkWireless->readBuffer(playerId, &myStruct, sizeof(myStruct));
+//       // (requires LINK_WIRELESS_ENABLE_BUFFERS and `retransmission`)
 // - 8) Disconnect:
 //       linkWireless->activate();
 //       // (resets the adapter)
+// - 9) (Optional) Read the statistics counters:
+//       LinkWireless::Stats stats = linkWireless->getStats();
+//       // (requires LINK_WIRELESS_ENABLE_STATS)
 // --------------------------------------------------------------------------
 // (*) libtonc's interrupt handler sometimes ignores interrupts due to a bug.
 //     That can cause packet loss. You might want to use libugba's instead.
@@ -50,17 +71,108 @@
 // --------------------------------------------------------------------------
 // `send(...)` restrictions:
 // - 0xFFFF is a reserved value, so don't use it!
+// - 0xFFFE is also reserved when LINK_WIRELESS_ENABLE_BUFFERS is enabled
+//   (it starts buffers, so it's refused with a RESERVED_DATA error)
 // --------------------------------------------------------------------------
 
 #include <tonc_core.h>
-#include <string>
+#include <algorithm>
 #include "LinkGPIO.h"
 #include "LinkSPI.h"
 
 // #include <functional>
 
-// Buffer size
-#define LINK_WIRELESS_QUEUE_SIZE 30
+// Game and user names as std::string (0 = char arrays, no heap allocations)
+#ifndef LINK_WIRELESS_USE_STD_STRING
+#define LINK_WIRELESS_USE_STD_STRING 1
+#endif
+
+#if LINK_WIRELESS_USE_STD_STRING
+#include <string>
+#endif
+
+// One header per group of messages instead of per message (0 = disabled, 1 =
+// enabled; all consoles must use the same value)
+#ifndef LINK_WIRELESS_USE_DENSE_FRAMING
+#define LINK_WIRELESS_USE_DENSE_FRAMING 0
+#endif
+
+// With `retransmission`, servers only confirm the clients that sent messages
+// since the previous transfer, instead of all of them on every transfer (0 =
+// disabled, 1 = enabled; clients are not affected)
+#ifndef LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS
+#define LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS 0
+#endif
+
+// Servers forward client messages as soon as they arrive (in the interrupt
+// handler), instead of when `receive(...)` reads them (0 = disabled, 1 =
+// enabled; clients are not affected)
+#ifndef LINK_WIRELESS_USE_ISR_FORWARDING
+#define LINK_WIRELESS_USE_ISR_FORWARDING 0
+#endif
+
+// Every transfer starts with a word that contains its length and a CRC-16 of
+// its content, and corrupted transfers are discarded as a whole (0 =
+// disabled, 1 = enabled; all consoles must use the same value)
+#ifndef LINK_WIRELESS_USE_TRANSFER_CRC
+#define LINK_WIRELESS_USE_TRANSFER_CRC 0
+#endif
+
+// Clients use SendDataWait and let the adapter wake them up when the host's
+// data arrives, instead of polling with ReceiveData (0 = disabled, 1 = enabled)
+#ifndef LINK_WIRELESS_USE_SEND_DATA_WAIT
+#define LINK_WIRELESS_USE_SEND_DATA_WAIT 0
+#endif
+
+// Byte buffers in `send(data, length)` (0 = disabled, 1 = enabled)
+#ifndef LINK_WIRELESS_ENABLE_BUFFERS
+#define LINK_WIRELESS_ENABLE_BUFFERS 0
+#endif
+
+// Max buffer length in `send(data, length)`, in bytes
+// (every player has two receive buffers of this size, plus one for sending)
+#ifndef LINK_WIRELESS_MAX_BUFFER_LENGTH
+#define LINK_WIRELESS_MAX_BUFFER_LENGTH 256
+#endif
+
+// Statistics counters (0 = disabled, 1 = enabled)
+#ifndef LINK_WIRELESS_ENABLE_STATS
+#define LINK_WIRELESS_ENABLE_STATS 0
+#endif
+
+// ISR profiling in LINK_WIRELESS_ISR_* (0 = disabled, 1 = enabled)
+#ifndef LINK_WIRELESS_ENABLE_PROFILER
+#define LINK_WIRELESS_ENABLE_PROFILER 0
+#endif
+
+#if LINK_WIRELESS_ENABLE_PROFILER
+#include "LinkProfiler.h"
+#define LINK_WIRELESS_PROFILE(HANDLER, CALL) \
+  linkProfiler->profile(LinkProfiler::Handler::HANDLER, []() { CALL; })
+#else
+#define LINK_WIRELESS_PROFILE(HANDLER, CALL) CALL
+#endif
+
+// ISRs and hot paths in IWRAM as ARM code (0 = disabled, 1 = enabled)
+// (it must be defined for all files, e.g. with
+//  -DLINK_WIRELESS_PUT_ISR_IN_IWRAM=1, since the LINK_WIRELESS_ISR_*
+//  functions are compiled in LinkWireless.iwram.cpp)
+#ifndef LINK_WIRELESS_PUT_ISR_IN_IWRAM
+#define LINK_WIRELESS_PUT_ISR_IN_IWRAM 0
+#endif
+
+#if LINK_WIRELESS_PUT_ISR_IN_IWRAM
+#define LINK_WIRELESS_IWRAM_CODE \
+  __attribute__((section(".iwram.link_wireless"), target("arm"), long_call))
+#define LINK_WIRELESS_IWRAM_DATA \
+  __attribute__((section(".iwram.link_wireless_data")))
+#else
+#define LINK_WIRELESS_IWRAM_CODE
+#define LINK_WIRELESS_IWRAM_DATA
+#endif
+
+// Buffer size (must be a power of two)
+#define LINK_WIRELESS_QUEUE_SIZE 32
 
 // Max command response length
 #define LINK_WIRELESS_MAX_COMMAND_RESPONSE_LENGTH 50
@@ -71,6 +183,14 @@
 // Max client transfer length
 #define LINK_WIRELESS_MAX_CLIENT_TRANSFER_LENGTH 4
 
+// (wireless header + transfer)
+#define LINK_WIRELESS_MAX_COMMAND_TRANSFER_LENGTH \
+  (1 + LINK_WIRELESS_MAX_SERVER_TRANSFER_LENGTH)
+
+// (wireless header + transfer CRC, if enabled)
+#define LINK_WIRELESS_TRANSFER_HEADER_LENGTH \
+  (1 + LINK_WIRELESS_USE_TRANSFER_CRC)
+
 #define LINK_WIRELESS_MAX_PLAYERS 5
 #define LINK_WIRELESS_MIN_PLAYERS 2
 #define LINK_WIRELESS_END 0
@@ -82,11 +202,36 @@
 #define LINK_WIRELESS_PACKET_ID_BITS 6
 #define LINK_WIRELESS_MAX_PACKET_IDS (1 << LINK_WIRELESS_PACKET_ID_BITS)
 #define LINK_WIRELESS_PACKET_ID_MASK (LINK_WIRELESS_MAX_PACKET_IDS - 1)
+#define LINK_WIRELESS_FRAME_COUNT_BITS 6
+#define LINK_WIRELESS_FRAME_COUNT_MASK \
+  ((1 << LINK_WIRELESS_FRAME_COUNT_BITS) - 1)
+#define LINK_WIRELESS_CLIENT_BYTES_BITS 5
+#define LINK_WIRELESS_CLIENT_BYTES_MASK \
+  ((1 << LINK_WIRELESS_CLIENT_BYTES_BITS) - 1)
+#define LINK_WIRELESS_CRC_SEED 0xffff
+#define LINK_WIRELESS_CRC_POLYNOMIAL 0x1021
+#define LINK_WIRELESS_PACKED_ID_SHIFT 19
+#define LINK_WIRELESS_PACKED_ID_MASK \
+  ((1 << (32 - LINK_WIRELESS_PACKED_ID_SHIFT)) - 1)
 #define LINK_WIRELESS_MSG_PING 0xffff
+#define LINK_WIRELESS_MSG_BUFFER 0xfffe
+#define LINK_WIRELESS_BUFFER_ESCAPED_BUFFER 0
+#define LINK_WIRELESS_BUFFER_ESCAPED_PING 1
+#define LINK_WIRELESS_BUFFER_START 2
 #define LINK_WIRELESS_PING_WAIT 50
 #define LINK_WIRELESS_TRANSFER_WAIT 15
+#define LINK_WIRELESS_CYCLES_PER_LINE 1232
+#define LINK_WIRELESS_ASYNC_START_INTERVAL                                \
+  ((LINK_WIRELESS_TRANSFER_WAIT * LINK_WIRELESS_CYCLES_PER_LINE + 1023) / \
+   1024)
+#define LINK_WIRELESS_ASYNC_PING_TICKS                           \
+  ((LINK_WIRELESS_PING_WAIT + LINK_WIRELESS_TRANSFER_WAIT - 1) / \
+   LINK_WIRELESS_TRANSFER_WAIT)
 #define LINK_WIRELESS_BROADCAST_SEARCH_WAIT_FRAMES 60
+#define LINK_WIRELESS_BROADCAST_POLL_FRAMES 6
+#define LINK_WIRELESS_ASYNC_COMMAND_TIMEOUT 228
 #define LINK_WIRELESS_CMD_TIMEOUT 100
+#define LINK_WIRELESS_REVERSE_ACK_TIMEOUT 10
 #define LINK_WIRELESS_MAX_GAME_NAME_LENGTH 14
 #define LINK_WIRELESS_MAX_USER_NAME_LENGTH 8
 #define LINK_WIRELESS_LOGIN_STEPS 9
@@ -98,7 +243,8 @@
 #define LINK_WIRELESS_BROADCAST_LENGTH 6
 #define LINK_WIRELESS_BROADCAST_RESPONSE_LENGTH \
   (1 + LINK_WIRELESS_BROADCAST_LENGTH)
-#define LINK_WIRELESS_MAX_TRANSFER_LENGTH 20
+#define LINK_WIRELESS_MAX_TRANSFER_LENGTH \
+  LINK_WIRELESS_QUEUE_SIZE  // (`receive(...)` can return a whole queue)
 #define LINK_WIRELESS_MAX_SERVERS              \
   (LINK_WIRELESS_MAX_COMMAND_RESPONSE_LENGTH / \
    LINK_WIRELESS_BROADCAST_RESPONSE_LENGTH)
@@ -114,9 +260,20 @@
 #define LINK_WIRELESS_COMMAND_IS_FINISHED_CONNECT 0x20
 #define LINK_WIRELESS_COMMAND_FINISH_CONNECTION 0x21
 #define LINK_WIRELESS_COMMAND_SEND_DATA 0x24
+#define LINK_WIRELESS_COMMAND_SEND_DATA_WAIT 0x25
 #define LINK_WIRELESS_COMMAND_RECEIVE_DATA 0x26
+#define LINK_WIRELESS_COMMAND_WAIT 0x27
+#define LINK_WIRELESS_EVENT_WAIT_TIMEOUT 0x27
+#define LINK_WIRELESS_EVENT_DATA_AVAILABLE 0x28
+#define LINK_WIRELESS_TOTAL_ERRORS 13
 #define LINK_WIRELESS_BARRIER asm volatile("" ::: "memory")
 
+#if LINK_WIRELESS_ENABLE_STATS
+#define LINK_WIRELESS_STATS(...) __VA_ARGS__
+#else
+#define LINK_WIRELESS_STATS(...)
+#endif
+
 #define LINK_WIRELESS_RESET_IF_NEEDED \
   if (!isEnabled)                     \
     return false;                     \
@@ -124,6 +281,19 @@
     if (!reset())                     \
       return false;
 
+#define LINK_WIRELESS_RESET_ASYNC_IF_NEEDED \
+  if (!isEnabled)                           \
+    return false;                           \
+  if (state == NEEDS_RESET)                 \
+    resetAsync();
+
+#define LINK_WIRELESS_WAIT_ASYNC_START_IF_NEEDED \
+  LINK_WIRELESS_RESET_ASYNC_IF_NEEDED            \
+  if (state == AUTHENTICATING) {                 \
+    setError(WRONG_STATE);                       \
+    return false;                                \
+  }
+
 static volatile char LINK_WIRELESS_VERSION[] = "LinkWireless/v5.0.2";
 
 void LINK_WIRELESS_ISR_VBLANK();
@@ -134,12 +304,32 @@ const u16 LINK_WIRELESS_LOGIN_PARTS[] = {0x494e, 0x494e, 0x544e, 0x544e, 0x4e45,
 const u16 LINK_WIRELESS_TIMER_IRQ_IDS[] = {IRQ_TIMER0, IRQ_TIMER1, IRQ_TIMER2,
                                            IRQ_TIMER3};
 
+#if LINK_WIRELESS_USE_TRANSFER_CRC
+// (CRC-16/CCITT lookup table, one entry per byte value, built at compile time)
+struct LinkWirelessCRCTable {
+  u16 entries[256] = {};
+
+  constexpr LinkWirelessCRCTable() {
+    for (u32 i = 0; i < 256; i++) {
+      u32 crc = i << 8;
+      for (u32 bit = 0; bit < 8; bit++)
+        crc = (crc << 1) ^ (crc & 0x8000 ? LINK_WIRELESS_CRC_POLYNOMIAL : 0);
+      entries[i] = crc;
+    }
+  }
+};
+// (inline, so all translation units share one copy)
+LINK_WIRELESS_IWRAM_DATA inline constexpr LinkWirelessCRCTable
+    LINK_WIRELESS_CRC_TABLE;
+#endif
+
 class LinkWireless {
  public:
   // std::function<void(std::string str)> debug;
 
   enum State {
     NEEDS_RESET,
+    AUTHENTICATING,
     AUTHENTICATED,
     SEARCHING,
     SERVING,
@@ -161,7 +351,9 @@ class LinkWireless {
     RECEIVE_DATA_FAILED = 8,
     ACKNOWLEDGE_FAILED = 9,
     TIMEOUT = 10,
-    REMOTE_TIMEOUT = 11
+    REMOTE_TIMEOUT = 11,
+    // User errors (with LINK_WIRELESS_ENABLE_BUFFERS)
+    RESERVED_DATA = 12
   };
 
   struct Message {
@@ -173,8 +365,34 @@ class LinkWireless {
 
   struct Server {
     u16 id = 0;
+#if LINK_WIRELESS_USE_STD_STRING
     std::string gameName;
     std::string userName;
+#else
+    char gameName[LINK_WIRELESS_MAX_GAME_NAME_LENGTH + 1] = {};
+    char userName[LINK_WIRELESS_MAX_USER_NAME_LENGTH + 1] = {};
+#endif
+  };
+
+  // (all counters start at zero on `activate()`)
+  struct Stats {
+    u32 sentMessages = 0;         // (accepted by `send(...)`)
+    u32 transferredMessages = 0;  // (including retransmissions)
+    u32 receivedMessages = 0;     // (moved to the incoming queue)
+    u32 droppedOutgoingMessages = 0;  // (full queue or inactive session)
+    u32 droppedIncomingMessages = 0;  // (full queue or inactive session)
+    u32 invalidMessages = 0;          // (wrong checksum)
+    u32 invalidTransfers = 0;         // (wrong CRC, if enabled)
+    u32 ignoredMessages = 0;          // (unexpected packet id)
+    u32 resets = 0;
+    u32 errors[LINK_WIRELESS_TOTAL_ERRORS] = {};  // (indexed by `Error`)
+    u32 vBlankIRQs = 0;
+    u32 serialIRQs = 0;
+    u32 timerIRQs = 0;
+    u32 outgoingQueueHighWaterMark = 0;
+    u32 incomingQueueHighWaterMark = 0;
+    u32 lastFrameTransferredMessages = 0;
+    u32 lastFrameReceivedMessages = 0;
   };
 
   explicit LinkWireless(
@@ -199,6 +417,7 @@ class LinkWireless {
   bool activate() {
     lastError = NONE;
     isEnabled = false;
+    LINK_WIRELESS_STATS(statsState = StatsState{});
 
     LINK_WIRELESS_BARRIER;
     bool success = reset();
@@ -208,6 +427,18 @@ class LinkWireless {
     return success;
   }
 
+  void activateAsync() {
+    lastError = NONE;
+    isEnabled = false;
+    LINK_WIRELESS_STATS(statsState = StatsState{});
+
+    LINK_WIRELESS_BARRIER;
+    resetAsync();
+    LINK_WIRELESS_BARRIER;
+
+    isEnabled = true;
+  }
+
   void deactivate() {
     lastError = NONE;
     isEnabled = false;
@@ -215,45 +446,46 @@ class LinkWireless {
     stop();
   }
 
+#if LINK_WIRELESS_USE_STD_STRING
   bool serve(std::string gameName = "", std::string userName = "") {
-    LINK_WIRELESS_RESET_IF_NEEDED
+    return serve(gameName.c_str(), userName.c_str());
+  }
+
+  bool serve(const char* gameName, const char* userName) {
+#else
+  bool serve(const char* gameName = "", const char* userName = "") {
+#endif
+    LINK_WIRELESS_WAIT_ASYNC_START_IF_NEEDED
     if (state != AUTHENTICATED) {
-      lastError = WRONG_STATE;
+      setError(WRONG_STATE);
       return false;
     }
-    if (gameName.length() > LINK_WIRELESS_MAX_GAME_NAME_LENGTH) {
-      lastError = GAME_NAME_TOO_LONG;
-      return false;
-    }
-    if (userName.length() > LINK_WIRELESS_MAX_GAME_NAME_LENGTH) {
-      lastError = USER_NAME_TOO_LONG;
+
+    char game[LINK_WIRELESS_MAX_GAME_NAME_LENGTH + 1];
+    char user[LINK_WIRELESS_MAX_USER_NAME_LENGTH + 1];
+    if (!copyName(game, gameName, LINK_WIRELESS_MAX_GAME_NAME_LENGTH)) {
+      setError(GAME_NAME_TOO_LONG);
       return false;
     }
-    gameName.append(LINK_WIRELESS_MAX_GAME_NAME_LENGTH - gameName.length(), 0);
-    userName.append(LINK_WIRELESS_MAX_USER_NAME_LENGTH - userName.length(), 0);
-
-    addData(buildU32(buildU16(gameName[1], gameName[0]), buildU16(0x02, 0x02)),
-            true);
-    addData(buildU32(buildU16(gameName[5], gameName[4]),
-                     buildU16(gameName[3], gameName[2])));
-    addData(buildU32(buildU16(gameName[9], gameName[8]),
-                     buildU16(gameName[7], gameName[6])));
-    addData(buildU32(buildU16(gameName[13], gameName[12]),
-                     buildU16(gameName[11], gameName[10])));
-    addData(buildU32(buildU16(userName[3], userName[2]),
-                     buildU16(userName[1], userName[0])));
-    addData(buildU32(buildU16(userName[7], userName[6]),
-                     buildU16(userName[5], userName[4])));
-    bool success = sendCommand(LINK_WIRELESS_COMMAND_BROADCAST, true).success &&
-                   sendCommand(LINK_WIRELESS_COMMAND_START_HOST).success;
-
-    if (!success) {
-      reset();
-      lastError = COMMAND_FAILED;
+    if (!copyName(user, userName, LINK_WIRELESS_MAX_USER_NAME_LENGTH)) {
+      setError(USER_NAME_TOO_LONG);
       return false;
     }
 
-    wait(LINK_WIRELESS_TRANSFER_WAIT);
+    // (the interrupts send the broadcast data and start the host, after a
+    //  pending BroadcastReadEnd)
+    u32* data = asyncLobby.broadcastData;
+    data[0] = buildU32(buildU16(game[1], game[0]), buildU16(0x02, 0x02));
+    data[1] = buildU32(buildU16(game[5], game[4]), buildU16(game[3], game[2]));
+    data[2] = buildU32(buildU16(game[9], game[8]), buildU16(game[7], game[6]));
+    data[3] = buildU32(buildU16(game[13], game[12]),
+                       buildU16(game[11], game[10]));
+    data[4] = buildU32(buildU16(user[3], user[2]), buildU16(user[1], user[0]));
+    data[5] = buildU32(buildU16(user[7], user[6]), buildU16(user[5], user[4]));
+    asyncLobby.didBroadcast = false;
+    asyncLobby.isHosting = false;
+    resetOutgoingBuffer();
+    LINK_WIRELESS_BARRIER;
     state = SERVING;
 
     return true;
@@ -265,6 +497,7 @@ class LinkWireless {
 
   template <typename F>
   bool getServers(Server servers[], F onWait) {
+    LINK_WIRELESS_RESET_IF_NEEDED
     if (!getServersAsyncStart())
       return false;
 
@@ -277,163 +510,183 @@ class LinkWireless {
   }
 
   bool getServersAsyncStart() {
-    LINK_WIRELESS_RESET_IF_NEEDED
+    LINK_WIRELESS_WAIT_ASYNC_START_IF_NEEDED
     if (state != AUTHENTICATED) {
-      lastError = WRONG_STATE;
-      return false;
-    }
-
-    bool success =
-        sendCommand(LINK_WIRELESS_COMMAND_BROADCAST_READ_START).success;
-
-    if (!success) {
-      reset();
-      lastError = COMMAND_FAILED;
+      setError(WRONG_STATE);
       return false;
     }
 
+    // (the interrupts start the search and poll it every few frames)
+    asyncLobby.pollFrames = 0;
+    asyncLobby.broadcastsSize = 0;
+    LINK_WIRELESS_BARRIER;
     state = SEARCHING;
 
     return true;
   }
 
-  bool getServersAsyncEnd(Server servers[]) {
-    LINK_WIRELESS_RESET_IF_NEEDED
-    if (state != SEARCHING) {
-      lastError = WRONG_STATE;
+  bool peekServers(Server servers[]) {
+    if (!isEnabled || state != SEARCHING) {
+      setError(WRONG_STATE);
       return false;
     }
 
-    auto result = sendCommand(LINK_WIRELESS_COMMAND_BROADCAST_READ_POLL);
-    bool success1 =
-        result.success &&
-        result.responsesSize % LINK_WIRELESS_BROADCAST_RESPONSE_LENGTH == 0;
+    readServers(servers);
 
-    if (!success1) {
-      reset();
-      lastError = COMMAND_FAILED;
-      return false;
-    }
-
-    bool success2 =
-        sendCommand(LINK_WIRELESS_COMMAND_BROADCAST_READ_END).success;
+    return true;
+  }
 
-    if (!success2) {
-      reset();
-      lastError = COMMAND_FAILED;
+  bool getServersAsyncEnd(Server servers[]) {
+    LINK_WIRELESS_WAIT_ASYNC_START_IF_NEEDED
+    if (state != SEARCHING) {
+      setError(WRONG_STATE);
       return false;
     }
 
-    u32 totalBroadcasts =
-        result.responsesSize / LINK_WIRELESS_BROADCAST_RESPONSE_LENGTH;
-
-    for (u32 i = 0; i < totalBroadcasts; i++) {
-      u32 start = LINK_WIRELESS_BROADCAST_RESPONSE_LENGTH * i;
-
-      Server server;
-      server.id = (u16)result.responses[start];
-      recoverName(server.gameName, result.responses[start + 1], false);
-      recoverName(server.gameName, result.responses[start + 2]);
-      recoverName(server.gameName, result.responses[start + 3]);
-      recoverName(server.gameName, result.responses[start + 4]);
-      recoverName(server.userName, result.responses[start + 5]);
-      recoverName(server.userName, result.responses[start + 6]);
-
-      servers[i] = server;
-    }
+    readServers(servers);
 
+    // (the interrupts end the search before sending other commands)
+    asyncLobby.shouldEndSearch = true;
+    LINK_WIRELESS_BARRIER;
     state = AUTHENTICATED;
 
     return true;
   }
 
   bool connect(u16 serverId) {
-    LINK_WIRELESS_RESET_IF_NEEDED
+    LINK_WIRELESS_WAIT_ASYNC_START_IF_NEEDED
     if (state != AUTHENTICATED) {
-      lastError = WRONG_STATE;
-      return false;
-    }
-
-    addData(serverId, true);
-    bool success = sendCommand(LINK_WIRELESS_COMMAND_CONNECT, true).success;
-
-    if (!success) {
-      reset();
-      lastError = COMMAND_FAILED;
+      setError(WRONG_STATE);
       return false;
     }
 
+    // (the interrupts send the request and poll it until it's accepted)
+    asyncLobby.serverId = serverId;
+    asyncLobby.didRequestConnection = false;
+    resetOutgoingBuffer();
+    LINK_WIRELESS_BARRIER;
     state = CONNECTING;
 
     return true;
   }
 
   bool keepConnecting() {
-    LINK_WIRELESS_RESET_IF_NEEDED
-    if (state != CONNECTING) {
-      lastError = WRONG_STATE;
+    if (!isEnabled)
       return false;
-    }
 
-    auto result1 = sendCommand(LINK_WIRELESS_COMMAND_IS_FINISHED_CONNECT);
-    if (!result1.success || result1.responsesSize == 0) {
-      reset();
-      lastError = COMMAND_FAILED;
+    if (state == CONNECTING || state == CONNECTED)
+      return true;
+
+    // (the connection failed and the adapter was reset)
+    if (lastError == NONE)
+      setError(WRONG_STATE);
+    return false;
+  }
+
+  bool send(u16 data, int _author = -1) {
+    LINK_WIRELESS_RESET_ASYNC_IF_NEEDED
+    if (!isSessionActive()) {
+      setError(WRONG_STATE);
       return false;
     }
+#if LINK_WIRELESS_ENABLE_BUFFERS
+    if (_author < 0) {
+      if (data == LINK_WIRELESS_MSG_BUFFER) {
+        setError(RESERVED_DATA);
+        return false;
+      }
 
-    if (result1.responses[0] == LINK_WIRELESS_STILL_CONNECTING)
-      return true;
+      // (own messages go after the rest of the buffer being sent)
+      sendBufferMessages();
+      if (outgoingBuffer.isSending) {
+        LINK_WIRELESS_STATS(stats().droppedOutgoingMessages++);
+        setError(BUFFER_IS_FULL);
+        return false;
+      }
+    }
+#endif
 
-    u8 assignedPlayerId = 1 + (u8)msB32(result1.responses[0]);
-    if (assignedPlayerId >= LINK_WIRELESS_MAX_PLAYERS) {
-      reset();
-      lastError = WEIRD_PLAYER_ID;
+    if (!canQueueMessage()) {
+      LINK_WIRELESS_STATS(stats().droppedOutgoingMessages++);
+      if (_author < 0)
+        setError(BUFFER_IS_FULL);
       return false;
     }
-
-    auto result2 = sendCommand(LINK_WIRELESS_COMMAND_FINISH_CONNECTION);
-    if (!result2.success) {
-      reset();
-      lastError = COMMAND_FAILED;
+#if !LINK_WIRELESS_USE_ISR_FORWARDING
+    if (_author < 0 && !reserveOwnSlot()) {
+      LINK_WIRELESS_STATS(stats().droppedOutgoingMessages++);
+      setError(BUFFER_IS_FULL);
       return false;
     }
+#endif
 
-    sessionState.currentPlayerId = assignedPlayerId;
-    state = CONNECTED;
+    pushMessage(data, _author >= 0 ? _author : sessionState.currentPlayerId);
 
     return true;
   }
 
-  bool send(u16 data, int _author = -1) {
-    LINK_WIRELESS_RESET_IF_NEEDED
-    if (!isSessionActive()) {
-      lastError = WRONG_STATE;
+#if LINK_WIRELESS_ENABLE_BUFFERS
+  bool send(const void* data, u32 length) {
+    LINK_WIRELESS_RESET_ASYNC_IF_NEEDED
+    if (!isSessionActive() || !config.retransmission) {
+      setError(WRONG_STATE);
       return false;
     }
 
-    if (!_canSend()) {
-      if (_author < 0)
-        lastError = BUFFER_IS_FULL;
+    if (length > LINK_WIRELESS_MAX_BUFFER_LENGTH || outgoingBuffer.isSending) {
+      setError(BUFFER_IS_FULL);
       return false;
     }
 
-    Message message;
-    message.playerId = _author >= 0 ? _author : sessionState.currentPlayerId;
-    message.data = data;
+    // (the buffer is split in 16-bit messages: a start code (0xFFFE + 2), the
+    //  length, the checksum and the payload, where 0xFFFF and 0xFFFE are
+    //  escaped as 0xFFFE + 1 and 0xFFFE + 0, so only a start code can begin a
+    //  buffer; they're queued as the outgoing queues get room, from this and
+    //  the next `send(...)` and `receive(...)` calls)
+    OutgoingBuffer& buffer = outgoingBuffer;
+    buffer = OutgoingBuffer{};
+    const u8* bytes = (const u8*)data;
+    for (u32 i = 0; i < length; i++)
+      buffer.data[i] = bytes[i];
+    buffer.length = length;
+    for (u32 i = 0; i < (length + 1) / 2; i++)
+      buffer.checksum += readBufferWord(buffer.data, length, i);
+    buffer.isSending = true;
+
+    sendBufferMessages();
+
+    return true;
+  }
+
+  bool isSendingBuffer() { return outgoingBuffer.isSending; }
+
+  bool canReadBuffer(u8 playerId) {
+    return playerId < LINK_WIRELESS_MAX_PLAYERS &&
+           readyBuffers[playerId].isReady;
+  }
+
+  u32 readBuffer(u8 playerId, void* data, u32 maxLength) {
+    if (!canReadBuffer(playerId))
+      return 0;
 
     LINK_WIRELESS_BARRIER;
-    isAddingMessage = true;
+    isReadingMessages = true;
     LINK_WIRELESS_BARRIER;
 
-    sessionState.tmpMessagesToSend.push(message);
+    ReadyBuffer& buffer = readyBuffers[playerId];
+    u32 length = buffer.length;
+    for (u32 i = 0; i < length && i < maxLength; i++)
+      ((u8*)data)[i] = buffer.data[i];
+    buffer.isReady = false;
+    publishIncomingBuffer(playerId);
 
     LINK_WIRELESS_BARRIER;
-    isAddingMessage = false;
+    isReadingMessages = false;
     LINK_WIRELESS_BARRIER;
 
-    return true;
+    return length;
   }
+#endif
 
   bool receive(Message messages[]) {
     if (!isEnabled || state == NEEDS_RESET || !isSessionActive())
@@ -443,11 +696,59 @@ class LinkWireless {
     isReadingMessages = true;
     LINK_WIRELESS_BARRIER;
 
+#if LINK_WIRELESS_ENABLE_BUFFERS
+    sendBufferMessages();
+    bool isWaiting[LINK_WIRELESS_MAX_PLAYERS] = {};
+#endif
+#if !LINK_WIRELESS_USE_ISR_FORWARDING
+    // (forwarded messages leave the server's share of the free slots, so its
+    //  own messages aren't starved when everyone is sending)
+    u32 freeSlots = freeOutgoingSlots();
+    u32 ownSlots = std::min(availableOwnSlots(), freeSlots);
+    u32 forwardingSlots = freeSlots - ownSlots;
+    bool isForwardingFull = false;
+#endif
+
+    // (messages that have to wait go back to the end of the queue, so after
+    //  one lap the queue keeps them in the same order)
     u32 i = 0;
-    while (!sessionState.incomingMessages.isEmpty()) {
-      auto message = sessionState.incomingMessages.pop();
-      messages[i] = message;
+    u32 pendingMessages = sessionState.incomingMessages.size();
+    while (pendingMessages > 0) {
+      pendingMessages--;
+      u32 packedMessage = sessionState.incomingMessages.pop();
+      auto message = unpackMessage(packedMessage);
+#if LINK_WIRELESS_ENABLE_BUFFERS
+      // (a player's messages wait while it has two unread buffers, but the
+      //  other players' messages go on)
+      u8 playerId = message.playerId;
+      if (playerId < LINK_WIRELESS_MAX_PLAYERS &&
+          (isWaiting[playerId] ||
+           (message.data == LINK_WIRELESS_MSG_BUFFER &&
+            incomingBuffers[playerId].isComplete))) {
+        isWaiting[playerId] = true;
+        sessionState.incomingMessages.push(packedMessage);
+        continue;
+      }
+#endif
+#if !LINK_WIRELESS_USE_ISR_FORWARDING
+      if (isForwarding()) {
+        if (isForwardingFull || forwardingSlots == 0 || !canQueueMessage()) {
+          // (it's forwarded when the outgoing queues have room)
+          isForwardingFull = true;
+          sessionState.incomingMessages.push(packedMessage);
+          continue;
+        }
+        forwardingSlots--;
+      }
+#endif
       forwardMessageIfNeeded(message);
+
+#if LINK_WIRELESS_ENABLE_BUFFERS
+      if (addToIncomingBuffer(message))
+        continue;
+#endif
+
+      messages[i] = message;
       i++;
     }
 
@@ -469,10 +770,12 @@ class LinkWireless {
       lastError = NONE;
     return error;
   }
-
-  ~LinkWireless() {
-    delete linkSPI;
-    delete linkGPIO;
+  Stats getStats() {
+#if LINK_WIRELESS_ENABLE_STATS
+    return stats();
+#else
+    return Stats{};
+#endif
   }
 
   bool _canSend() { return !sessionState.outgoingMessages.isFull(); }
@@ -489,16 +792,35 @@ class LinkWireless {
   }
   u32 _lastPacketIdFromServer() { return sessionState.lastPacketIdFromServer; }
   u32 _nextPendingPacketId() {
-    return sessionState.outgoingMessages.isEmpty()
-               ? 0
-               : sessionState.outgoingMessages.peek().packetId;
+    return sessionState.outgoingMessages.peekPacketId();
+  }
+#if LINK_WIRELESS_USE_TRANSFER_CRC
+  LINK_WIRELESS_IWRAM_CODE static u32 _buildTransferCRC(const u32* data,
+                                                         u32 size) {
+    // (the CRC covers the size and the little-endian bytes of the data, and
+    //  goes in the low half; the size goes in the high half)
+    u32 crc = updateCRC(LINK_WIRELESS_CRC_SEED, size);
+    for (u32 i = 0; i < size; i++) {
+      u32 word = data[i];
+      for (u32 byte = 0; byte < 4; byte++) {
+        crc = updateCRC(crc, word);
+        word >>= 8;
+      }
+    }
+
+    return (size << 16) | crc;
   }
+#endif
 
-  void _onVBlank() {
+  LINK_WIRELESS_IWRAM_CODE void _onVBlank() {
     if (!isEnabled)
       return;
 
+    LINK_WIRELESS_STATS(updateFrameStats());
+
     if (!isSessionActive()) {
+      if (state == SEARCHING)
+        asyncLobby.pollFrames++;
       copyState();
       return;
     }
@@ -513,24 +835,33 @@ class LinkWireless {
     copyState();
   }
 
-  void _onSerial() {
+  LINK_WIRELESS_IWRAM_CODE void _onSerial() {
     if (!isEnabled)
       return;
 
-    linkSPI->_onSerial(true);
+    LINK_WIRELESS_STATS(stats().serialIRQs++);
+
+    bool isLoggingIn = state == AUTHENTICATING &&
+                       asyncStart.step == AsyncStart::Step::LOGIN;
+    linkSPI._onSerial(!isLoggingIn);  // (login packets don't use the ACK)
 
-    bool hasNewData = linkSPI->getAsyncState() == LinkSPI::AsyncState::READY;
+    bool hasNewData = linkSPI.getAsyncState() == LinkSPI::AsyncState::READY;
     if (hasNewData) {
-      if (!acknowledge()) {
-        reset();
-        lastError = ACKNOWLEDGE_FAILED;
+      if (!isLoggingIn && !acknowledge()) {
+        resetAsync(state == AUTHENTICATING);
+        setError(ACKNOWLEDGE_FAILED);
         return;
       }
     } else
       return;
-    u32 newData = linkSPI->getAsyncData();
+    u32 newData = linkSPI.getAsyncData();
 
-    if (!isSessionActive())
+    if (isLoggingIn) {
+      receiveLoginPacket(newData);
+      return;
+    }
+
+    if (state == NEEDS_RESET)
       return;
 
     if (asyncCommand.isActive) {
@@ -543,16 +874,27 @@ class LinkWireless {
     }
   }
 
-  void _onTimer() {
+  LINK_WIRELESS_IWRAM_CODE void _onTimer() {
     if (!isEnabled)
       return;
 
-    if (!isSessionActive())
+    LINK_WIRELESS_STATS(stats().timerIRQs++);
+
+    if (state == AUTHENTICATING) {
+      if (!asyncCommand.isActive)
+        updateAsyncStart();
+      return;
+    }
+
+    if (!isSessionActive() || (state == SERVING && !asyncLobby.isHosting)) {
+      if (!asyncCommand.isActive)
+        updateAsyncLobby();
       return;
+    }
 
     if (sessionState.recvTimeout >= config.timeout) {
-      reset();
-      lastError = TIMEOUT;
+      resetAsync();
+      setError(TIMEOUT);
       return;
     }
 
@@ -560,7 +902,28 @@ class LinkWireless {
       acceptConnectionsOrSendData();
   }
 
+  // (interrupt service routines bound to an instance with static storage,
+  //  so they don't read a global pointer)
+  template <LinkWireless& instance>
+  struct ISR {
+    LINK_WIRELESS_IWRAM_CODE static void VBLANK() {
+      LINK_WIRELESS_PROFILE(WIRELESS_VBLANK, instance._onVBlank());
+    }
+
+    LINK_WIRELESS_IWRAM_CODE static void SERIAL() {
+      LINK_WIRELESS_PROFILE(WIRELESS_SERIAL, instance._onSerial());
+    }
+
+    LINK_WIRELESS_IWRAM_CODE static void TIMER() {
+      LINK_WIRELESS_PROFILE(WIRELESS_TIMER, instance._onTimer());
+    }
+  };
+
  private:
+  // (host tests drive the session protocol without adapters, see
+  //  `lib/host/tests/LinkWirelessLoopback.h`)
+  friend struct LinkWirelessLoopback;
+
   struct Config {
     bool forwarding;
     bool retransmission;
@@ -572,65 +935,90 @@ class LinkWireless {
   };
 
   class MessageQueue {
+    static_assert(LINK_WIRELESS_QUEUE_SIZE > 0 &&
+                      (LINK_WIRELESS_QUEUE_SIZE &
+                       (LINK_WIRELESS_QUEUE_SIZE - 1)) == 0,
+                  "LINK_WIRELESS_QUEUE_SIZE must be a power of two");
+    static constexpr u32 MASK = LINK_WIRELESS_QUEUE_SIZE - 1;
+
    public:
-    void push(Message item) {
+    LINK_WIRELESS_IWRAM_CODE bool push(u32 item) {
       if (isFull())
-        return;
+        return false;
 
-      rear = (rear + 1) % LINK_WIRELESS_QUEUE_SIZE;
-      arr[rear] = item;
-      count++;
+      arr[rear & MASK] = item;
+      rear++;
+
+      return true;
     }
 
-    Message pop() {
+    LINK_WIRELESS_IWRAM_CODE u32 pop() {
       if (isEmpty())
-        return Message{};
+        return 0;
 
-      auto x = arr[front];
-      front = (front + 1) % LINK_WIRELESS_QUEUE_SIZE;
-      count--;
+      u32 x = arr[front & MASK];
+      front++;
 
       return x;
     }
 
-    Message peek() {
+    u32 peek() {
       if (isEmpty())
-        return Message{};
-      return arr[front];
+        return 0;
+      return arr[front & MASK];
     }
 
     template <typename F>
     void forEach(F action) {
-      int currentFront = front;
+      u32 currentRear = rear;
 
-      for (u32 i = 0; i < count; i++) {
-        if (!action(arr[currentFront]))
+      for (u32 i = front; i != currentRear; i++) {
+        if (!action(arr[i & MASK]))
           return;
-        currentFront = (currentFront + 1) % LINK_WIRELESS_QUEUE_SIZE;
       }
     }
 
-    void clear() {
-      while (!isEmpty())
-        pop();
-    }
+    void clear() { front = rear; }
 
-    int size() { return count; }
+    u32 size() { return rear - front; }
     bool isEmpty() { return size() == 0; }
     bool isFull() { return size() == LINK_WIRELESS_QUEUE_SIZE; }
 
    private:
-    Message arr[LINK_WIRELESS_QUEUE_SIZE];
-    vs32 front = 0;
-    vs32 rear = -1;
-    vu32 count = 0;
+    u32 arr[LINK_WIRELESS_QUEUE_SIZE];
+    vu32 front = 0;  // (free-running indexes, masked on access)
+    vu32 rear = 0;
+  };
+
+  // (raw messages waiting for confirmation have consecutive packet ids,
+  //  so only the id of the first one is stored)
+  class OutgoingMessageQueue : public MessageQueue {
+   public:
+    LINK_WIRELESS_IWRAM_CODE bool push(u32 rawMessage, u32 packetId) {
+      if (isEmpty())
+        frontPacketId = packetId;
+      return MessageQueue::push(rawMessage);
+    }
+
+    void pop() {
+      if (isEmpty())
+        return;
+
+      MessageQueue::pop();
+      frontPacketId++;
+    }
+
+    u32 peekPacketId() { return isEmpty() ? 0 : frontPacketId; }
+
+   private:
+    u32 frontPacketId = 0;
   };
 
   struct SessionState {
-    MessageQueue incomingMessages;      // read by user, write by irq&user
-    MessageQueue outgoingMessages;      // read and write by irq
-    MessageQueue tmpMessagesToReceive;  // read and write by irq
-    MessageQueue tmpMessagesToSend;     // read by irq, write by user&irq
+    MessageQueue incomingMessages;          // read by user, write by irq&user
+    OutgoingMessageQueue outgoingMessages;  // read and write by irq
+    MessageQueue tmpMessagesToReceive;      // read and write by irq
+    MessageQueue tmpMessagesToSend;         // read by irq, write by user&irq
     u32 timeouts[LINK_WIRELESS_MAX_PLAYERS];
     u32 recvTimeout = 0;
     u32 frameRecvCount = 0;
@@ -648,6 +1036,27 @@ class LinkWireless {
     u32 lastConfirmationFromServer = 0;
     u32 lastPacketIdFromClients[LINK_WIRELESS_MAX_PLAYERS];
     u32 lastConfirmationFromClients[LINK_WIRELESS_MAX_PLAYERS];
+    u8 confirmingPlayers = 0;  // (bit mask of player ids)
+    u8 receivingTurn = 0;      // (the client transfer that is read first)
+
+#if !LINK_WIRELESS_USE_ISR_FORWARDING
+    // (free slots of the outgoing queue that the server's own messages can
+    //  use before the next transfer: `grantedOwnSlots - usedOwnSlots`)
+    u32 grantedOwnSlots = 0;  // written by irq
+    u32 usedOwnSlots = 0;     // written by user
+#endif
+
+#if LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS
+    u8 pendingConfirmations = 0;  // (bit mask of client ids)
+    u8 lastRefreshedClient = 0;
+#endif
+
+#if LINK_WIRELESS_USE_ISR_FORWARDING
+    // (free slots of the outgoing queue that each client can use for its
+    //  forwarded messages during the current transfer)
+    u32 forwardingQuotas[LINK_WIRELESS_MAX_PLAYERS];
+    u8 forwardingTurn = 0;
+#endif
   };
 
   struct MessageHeader {
@@ -663,11 +1072,48 @@ class LinkWireless {
     u16 asInt;
   };
 
+#if LINK_WIRELESS_USE_DENSE_FRAMING
+  struct OutgoingFrame {
+    u32 headerIndex = 0;
+    u32 packetId = 0;
+    u32 count = 0;
+    u32 checksum = 0;
+    u8 playerId = 0;
+  };
+
+  static_assert(LINK_WIRELESS_MAX_SERVER_TRANSFER_LENGTH * 2 <=
+                    LINK_WIRELESS_FRAME_COUNT_MASK,
+                "Frames can't hold a whole transfer");
+#endif
+
   struct LoginMemory {
     u16 previousGBAData = 0xffff;
     u16 previousAdapterData = 0xffff;
   };
 
+  struct AsyncStart {
+    enum Step { PING, LOGIN, HELLO };
+
+    Step step = PING;
+    u32 pingTicks = 0;
+    u32 loginPackets = 0;  // (exchanged packets, out of `1 + LOGIN_STEPS`)
+    LoginMemory memory;
+  };
+
+  struct AsyncLobby {
+    u32 broadcasts[LINK_WIRELESS_MAX_COMMAND_RESPONSE_LENGTH];
+    u32 broadcastsSize = 0;  // (from the last BroadcastReadPoll)
+    u32 pollFrames = 0;
+    bool isSearching = false;  // (BroadcastReadStart was sent)
+    bool shouldEndSearch = false;
+    u32 broadcastData[LINK_WIRELESS_BROADCAST_LENGTH];
+    bool didBroadcast = false;  // (Broadcast was sent, while SERVING)
+    bool isHosting = false;     // (StartHost was sent, while SERVING)
+    u16 serverId = 0;
+    bool didRequestConnection = false;
+    u8 assignedPlayerId = 0;
+  };
+
   struct CommandResult {
     bool success = false;
     u32 responses[LINK_WIRELESS_MAX_COMMAND_RESPONSE_LENGTH];
@@ -681,11 +1127,13 @@ class LinkWireless {
       COMMAND_HEADER,
       COMMAND_PARAMETERS,
       RESPONSE_REQUEST,
-      DATA_REQUEST
+      DATA_REQUEST,
+      ADAPTER_COMMAND,  // (after a Wait, the adapter sends a command...)
+      ADAPTER_ACK       // (...and the GBA acknowledges it)
     };
 
     u8 type;
-    u32 parameters[LINK_WIRELESS_MAX_SERVER_TRANSFER_LENGTH];
+    u32 parameters[LINK_WIRELESS_MAX_COMMAND_TRANSFER_LENGTH];
     u32 responses[LINK_WIRELESS_MAX_COMMAND_RESPONSE_LENGTH];
     CommandResult result;
     State state;
@@ -695,41 +1143,441 @@ class LinkWireless {
     bool isActive;
   };
 
+#if LINK_WIRELESS_ENABLE_BUFFERS
+  struct IncomingBuffer {
+    enum Step { IDLE, LENGTH, CHECKSUM, PAYLOAD };
+
+    u8 data[LINK_WIRELESS_MAX_BUFFER_LENGTH];
+    u32 length = 0;
+    u32 receivedBytes = 0;
+    u16 expectedChecksum = 0;
+    u16 checksum = 0;
+    Step step = IDLE;
+    bool isEscaping = false;
+    bool isDiscarding = false;  // (its words are consumed, but not stored)
+    bool isComplete = false;  // (and waiting for the previous one to be read)
+  };
+
+  struct ReadyBuffer {
+    u8 data[LINK_WIRELESS_MAX_BUFFER_LENGTH];
+    u32 length = 0;
+    bool isReady = false;
+  };
+
+  struct OutgoingBuffer {
+    u8 data[LINK_WIRELESS_MAX_BUFFER_LENGTH];
+    u32 length = 0;
+    u16 checksum = 0;
+    u32 sentHeaders = 0;  // (start code escape, start code, length)
+    u32 sentWords = 0;    // (the checksum, and then the payload)
+    bool isEscaping = false;
+    bool isSending = false;
+  };
+
+  static_assert(LINK_WIRELESS_MAX_BUFFER_LENGTH < LINK_WIRELESS_MSG_BUFFER,
+                "The length message can't be escaped");
+
+  IncomingBuffer incomingBuffers[LINK_WIRELESS_MAX_PLAYERS];
+  ReadyBuffer readyBuffers[LINK_WIRELESS_MAX_PLAYERS];
+  OutgoingBuffer outgoingBuffer;  // (user only)
+#endif
+
   SessionState sessionState;
   AsyncCommand asyncCommand;
+  AsyncStart asyncStart;
+  AsyncLobby asyncLobby;
   Config config;
-  LinkSPI* linkSPI = new LinkSPI();
-  LinkGPIO* linkGPIO = new LinkGPIO();
+  LinkSPI linkSPI;
+  LinkGPIO linkGPIO;
   State state = NEEDS_RESET;
-  u32 nextCommandData[LINK_WIRELESS_MAX_SERVER_TRANSFER_LENGTH];
+  u32 nextCommandData[LINK_WIRELESS_MAX_COMMAND_TRANSFER_LENGTH];
   u32 nextCommandDataSize = 0;
   volatile bool isReadingMessages = false;
+  volatile bool isReadingServers = false;
   volatile bool isAddingMessage = false;
   volatile bool isPendingClearActive = false;
   Error lastError = NONE;
   bool isEnabled = false;
+#if LINK_WIRELESS_ENABLE_STATS
+  struct StatsState {
+    Stats stats;
+    u32 frameTransferred = 0;  // (`transferredMessages` on the last VBlank)
+    u32 frameReceived = 0;     // (`receivedMessages` on the last VBlank)
+  };
+  StatsState statsState;
+
+  Stats& stats() { return statsState.stats; }
+
+  void updateFrameStats() {  // (irq only)
+    Stats& stats = statsState.stats;
+    stats.vBlankIRQs++;
+    stats.lastFrameTransferredMessages =
+        stats.transferredMessages - statsState.frameTransferred;
+    stats.lastFrameReceivedMessages =
+        stats.receivedMessages - statsState.frameReceived;
+    statsState.frameTransferred = stats.transferredMessages;
+    statsState.frameReceived = stats.receivedMessages;
+  }
+
+  void countSentMessage(bool success) {
+    if (success)
+      statsState.stats.sentMessages++;
+    else
+      statsState.stats.droppedOutgoingMessages++;
+  }
+
+  void countQueuedMessage() {  // (irq only)
+    Stats& stats = statsState.stats;
+    u32 size = sessionState.outgoingMessages.size();
+    if (size > stats.outgoingQueueHighWaterMark)
+      stats.outgoingQueueHighWaterMark = size;
+  }
+
+  void countReceivedMessage(bool success, bool isFinal) {  // (irq only)
+    Stats& stats = statsState.stats;
+    u32 size = sessionState.incomingMessages.size();
+    if (!success)
+      stats.droppedIncomingMessages++;
+    else if (isFinal) {
+      stats.receivedMessages++;
+      if (size > stats.incomingQueueHighWaterMark)
+        stats.incomingQueueHighWaterMark = size;
+    }
+  }
+#endif
+
+  void setError(Error error) {
+    lastError = error;
+    LINK_WIRELESS_STATS(stats().errors[error]++);
+  }
+
+#if LINK_WIRELESS_ENABLE_BUFFERS
+  static u16 readBufferWord(const u8* bytes, u32 length, u32 index) {
+    u32 i = index * 2;
+    return bytes[i] | (i + 1 < length ? bytes[i + 1] << 8 : 0);
+  }
+
+  void sendBufferMessages() {  // (user only)
+    while (outgoingBuffer.isSending && canQueueMessage()) {
+#if !LINK_WIRELESS_USE_ISR_FORWARDING
+      if (!reserveOwnSlot())
+        break;
+#endif
+      pushMessage(nextBufferMessage(), sessionState.currentPlayerId);
+    }
+  }
+
+  u16 nextBufferMessage() {  // (user only)
+    OutgoingBuffer& buffer = outgoingBuffer;
+    if (buffer.sentHeaders < 3) {
+      const u16 headers[] = {LINK_WIRELESS_MSG_BUFFER,
+                             LINK_WIRELESS_BUFFER_START, (u16)buffer.length};
+      return headers[buffer.sentHeaders++];
+    }
+
+    u16 word = buffer.sentWords == 0
+                   ? buffer.checksum
+                   : readBufferWord(buffer.data, buffer.length,
+                                    buffer.sentWords - 1);
+    if (word >= LINK_WIRELESS_MSG_BUFFER) {
+      buffer.isEscaping = !buffer.isEscaping;
+      if (buffer.isEscaping)
+        return LINK_WIRELESS_MSG_BUFFER;
+
+      word = word == LINK_WIRELESS_MSG_PING
+                 ? LINK_WIRELESS_BUFFER_ESCAPED_PING
+                 : LINK_WIRELESS_BUFFER_ESCAPED_BUFFER;
+    }
+
+    buffer.sentWords++;
+    if (buffer.sentWords == 1 + (buffer.length + 1) / 2)
+      buffer.isSending = false;
+
+    return word;
+  }
+
+  bool addToIncomingBuffer(Message& message) {  // (user only)
+    if (message.playerId >= LINK_WIRELESS_MAX_PLAYERS)
+      return false;
+
+    IncomingBuffer& buffer = incomingBuffers[message.playerId];
+    u16 data = message.data;
+
+    // (escape codes are checked in every step, so a start code always begins a
+    //  new buffer, dropping an unfinished one)
+    if (buffer.isEscaping) {
+      buffer.isEscaping = false;
+
+      if (data == LINK_WIRELESS_BUFFER_START) {
+        buffer = IncomingBuffer{};
+        buffer.step = IncomingBuffer::LENGTH;
+        return true;
+      }
+      if (buffer.step == IncomingBuffer::IDLE)
+        return true;  // (not part of a buffer, but reserved anyway)
+
+      if (data == LINK_WIRELESS_BUFFER_ESCAPED_PING)
+        data = LINK_WIRELESS_MSG_PING;
+      else if (data == LINK_WIRELESS_BUFFER_ESCAPED_BUFFER)
+        data = LINK_WIRELESS_MSG_BUFFER;
+      else
+        buffer.isDiscarding = true;  // (it still counts as a payload word)
+    } else if (data == LINK_WIRELESS_MSG_BUFFER) {
+      buffer.isEscaping = true;
+      return true;
+    }
+
+    switch (buffer.step) {
+      case IncomingBuffer::IDLE: {
+        return false;
+      }
+      case IncomingBuffer::LENGTH: {
+        // (a buffer that's too long is discarded, but its words are skipped
+        //  anyway, so they don't end up as messages)
+        buffer.length = data;
+        buffer.isDiscarding =
+            buffer.isDiscarding || data > LINK_WIRELESS_MAX_BUFFER_LENGTH;
+        buffer.step = IncomingBuffer::CHECKSUM;
+        return true;
+      }
+      case IncomingBuffer::CHECKSUM: {
+        buffer.expectedChecksum = data;
+        buffer.step = IncomingBuffer::PAYLOAD;
+        break;
+      }
+      case IncomingBuffer::PAYLOAD: {
+        buffer.checksum += data;
+        for (u32 i = 0; i < 2 && buffer.receivedBytes < buffer.length; i++) {
+          if (!buffer.isDiscarding)
+            buffer.data[buffer.receivedBytes] = (data >> (i * 8)) & 0xff;
+          buffer.receivedBytes++;
+        }
+        break;
+      }
+    }
+
+    if (buffer.receivedBytes == buffer.length) {
+      buffer.step = IncomingBuffer::IDLE;
+      buffer.isComplete =
+          !buffer.isDiscarding && buffer.checksum == buffer.expectedChecksum;
+      if (buffer.isComplete)
+        publishIncomingBuffer(message.playerId);
+      else
+        buffer = IncomingBuffer{};
+    }
+
+    return true;
+  }
+
+  void publishIncomingBuffer(u8 playerId) {  // (user only)
+    // (a complete buffer waits in the reassembly one while the previous one
+    //  isn't read, so only a third buffer holds back the player's messages)
+    IncomingBuffer& buffer = incomingBuffers[playerId];
+    ReadyBuffer& readyBuffer = readyBuffers[playerId];
+    if (!buffer.isComplete || readyBuffer.isReady)
+      return;
+
+    for (u32 i = 0; i < buffer.length; i++)
+      readyBuffer.data[i] = buffer.data[i];
+    readyBuffer.length = buffer.length;
+    readyBuffer.isReady = true;
+    buffer = IncomingBuffer{};
+  }
+#endif
+
+  void resetOutgoingBuffer() {  // (user only)
+    // (a buffer cut by a reset isn't continued in the next session)
+#if LINK_WIRELESS_ENABLE_BUFFERS
+    outgoingBuffer.isSending = false;
+#endif
+  }
 
   void forwardMessageIfNeeded(Message& message) {
-    if (state == SERVING && config.forwarding && sessionState.playerCount > 2)
+#if !LINK_WIRELESS_USE_ISR_FORWARDING
+    if (isForwarding())
       send(message.data, message.playerId);
+#endif
+  }
+
+  bool isForwarding() {
+    return state == SERVING && config.forwarding &&
+           sessionState.playerCount > 2;
+  }
+
+  bool canQueueMessage() {
+    return _canSend() && !sessionState.tmpMessagesToSend.isFull();
+  }
+
+  void pushMessage(u16 data, u8 playerId) {  // (user only)
+    LINK_WIRELESS_BARRIER;
+    isAddingMessage = true;
+    LINK_WIRELESS_BARRIER;
+
+    [[maybe_unused]] bool success =
+        sessionState.tmpMessagesToSend.push(packMessage(0, data, playerId));
+
+    LINK_WIRELESS_BARRIER;
+    isAddingMessage = false;
+    LINK_WIRELESS_BARRIER;
+
+    LINK_WIRELESS_STATS(countSentMessage(success));
+  }
+
+#if !LINK_WIRELESS_USE_ISR_FORWARDING
+  bool reserveOwnSlot() {  // (user only)
+    // (while client messages wait to be forwarded, the server's own ones
+    //  only take its share of the slots freed by each transfer)
+    if (!isForwarding() || sessionState.incomingMessages.isEmpty())
+      return true;
+    if (availableOwnSlots() == 0)
+      return false;
+
+    sessionState.usedOwnSlots++;
+    return true;
+  }
+
+  u32 availableOwnSlots() {
+    u32 granted = sessionState.grantedOwnSlots;
+    u32 used = sessionState.usedOwnSlots;
+    return granted > used ? granted - used : 0;
+  }
+
+  void grantOwnSlots() {  // (irq only)
+    u32 playerCount = sessionState.playerCount;
+    u32 share = (freeOutgoingSlots() + playerCount - 1) / playerCount;
+    sessionState.grantedOwnSlots = sessionState.usedOwnSlots + share;
+  }
+#endif
+
+  u32 freeOutgoingSlots() {
+    u32 usedSlots = sessionState.outgoingMessages.size() +
+                    sessionState.tmpMessagesToSend.size();
+    return usedSlots < LINK_WIRELESS_QUEUE_SIZE
+               ? LINK_WIRELESS_QUEUE_SIZE - usedSlots
+               : 0;
   }
 
-  void processAsyncCommand() {  // (irq only)
+  LINK_WIRELESS_IWRAM_CODE void processAsyncCommand() {  // (irq only)
     if (!asyncCommand.result.success) {
-      if (asyncCommand.type == LINK_WIRELESS_COMMAND_SEND_DATA)
-        lastError = SEND_DATA_FAILED;
+      if (asyncCommand.type == LINK_WIRELESS_COMMAND_SEND_DATA ||
+          asyncCommand.type == LINK_WIRELESS_COMMAND_SEND_DATA_WAIT)
+        setError(SEND_DATA_FAILED);
       else if (asyncCommand.type == LINK_WIRELESS_COMMAND_RECEIVE_DATA)
-        lastError = RECEIVE_DATA_FAILED;
+        setError(RECEIVE_DATA_FAILED);
       else
-        lastError = COMMAND_FAILED;
+        setError(COMMAND_FAILED);
+
+      resetAsync(state == AUTHENTICATING);
+      return;
+    }
+
+    asyncCommand.isActive = false;
+
+    switch (asyncCommand.type) {
+      case LINK_WIRELESS_COMMAND_HELLO: {
+        // Hello (end)
+        if (state != AUTHENTICATING)
+          break;
+
+        // Setup (start)
+        addData(LINK_WIRELESS_SETUP_MAGIC, true);
+        sendCommandAsync(LINK_WIRELESS_COMMAND_SETUP, true);
+
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_SETUP: {
+        // Setup (end)
+        if (state != AUTHENTICATING)
+          break;
+
+        linkSPI.activate(LinkSPI::Mode::MASTER_2MBPS);
+        startTimer(config.interval);
+        state = AUTHENTICATED;
+
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_BROADCAST_READ_START: {
+        // Broadcast read start (end)
+        asyncLobby.isSearching = true;
+
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_BROADCAST_READ_POLL: {
+        // Broadcast read poll (end)
+        u32 responsesSize = asyncCommand.result.responsesSize;
+        if (responsesSize % LINK_WIRELESS_BROADCAST_RESPONSE_LENGTH != 0) {
+          resetAsync();
+          setError(COMMAND_FAILED);
+          return;
+        }
+
+        if (state == SEARCHING && !isReadingServers) {
+          for (u32 i = 0; i < responsesSize; i++)
+            asyncLobby.broadcasts[i] = asyncCommand.result.responses[i];
+          asyncLobby.broadcastsSize = responsesSize;
+        }
+
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_BROADCAST_READ_END: {
+        // Broadcast read end (end)
+        asyncLobby.isSearching = false;
+
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_BROADCAST: {
+        // Broadcast (end)
+        asyncLobby.didBroadcast = true;
+
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_START_HOST: {
+        // Start host (end)
+        asyncLobby.isHosting = true;
+
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_CONNECT: {
+        // Connect (end)
+        asyncLobby.didRequestConnection = true;
+
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_IS_FINISHED_CONNECT: {
+        // Is finished connect (end)
+        if (asyncCommand.result.responsesSize == 0) {
+          resetAsync();
+          setError(COMMAND_FAILED);
+          return;
+        }
+
+        u32 response = asyncCommand.result.responses[0];
+        if (response == LINK_WIRELESS_STILL_CONNECTING || state != CONNECTING)
+          break;
+
+        u8 assignedPlayerId = 1 + (u8)msB32(response);
+        if (assignedPlayerId >= LINK_WIRELESS_MAX_PLAYERS) {
+          resetAsync();
+          setError(WEIRD_PLAYER_ID);
+          return;
+        }
+        asyncLobby.assignedPlayerId = assignedPlayerId;
 
-      reset();
-      return;
-    }
+        // Finish connection (start)
+        sendCommandAsync(LINK_WIRELESS_COMMAND_FINISH_CONNECTION);
 
-    asyncCommand.isActive = false;
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_FINISH_CONNECTION: {
+        // Finish connection (end)
+        if (state != CONNECTING)
+          break;
 
-    switch (asyncCommand.type) {
+        sessionState.currentPlayerId = asyncLobby.assignedPlayerId;
+        state = CONNECTED;
+
+        break;
+      }
       case LINK_WIRELESS_COMMAND_ACCEPT_CONNECTIONS: {
         // Accept connections (end)
         sessionState.playerCount = 1 + asyncCommand.result.responsesSize;
@@ -761,18 +1609,130 @@ class LinkWireless {
           return;
 
         if (!checkRemoteTimeouts()) {
-          reset();
-          lastError = REMOTE_TIMEOUT;
+          resetAsync();
+          setError(REMOTE_TIMEOUT);
+          return;
+        }
+
+#if LINK_WIRELESS_USE_SEND_DATA_WAIT
+        // (reply right away, so clients send once per host transfer; the new
+        //  messages reach the game loop now, and its replies go in the next
+        //  SendDataWait, instead of waiting for VBlank)
+        if (state == CONNECTED) {
+          copyState();
+          sendPendingData(LINK_WIRELESS_COMMAND_SEND_DATA_WAIT);
+        }
+#endif
+
+        break;
+      }
+#if LINK_WIRELESS_USE_SEND_DATA_WAIT
+      case LINK_WIRELESS_COMMAND_SEND_DATA_WAIT: {
+        // Send data and wait (end)
+        waitForAdapterCommand();
+
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_WAIT: {
+        // Wait (end)
+        if (!resumeAfterWait())
           return;
+
+        if (asyncCommand.result.responses[0] ==
+            LINK_WIRELESS_EVENT_DATA_AVAILABLE) {
+          // Receive data (start)
+          sendCommandAsync(LINK_WIRELESS_COMMAND_RECEIVE_DATA);
         }
 
         break;
       }
+#endif
       default: {
       }
     }
   }
 
+#if LINK_WIRELESS_USE_SEND_DATA_WAIT
+  void waitForAdapterCommand() {  // (irq only)
+    // (the adapter takes control of the clock until the host's data arrives,
+    //  or ~500ms pass)
+    linkSPI.activate(LinkSPI::Mode::SLAVE);
+    if (!reverseAcknowledge()) {
+      resetAsync();
+      setError(ACKNOWLEDGE_FAILED);
+      return;
+    }
+
+    asyncCommand.type = LINK_WIRELESS_COMMAND_WAIT;
+    asyncCommand.result.success = false;
+    asyncCommand.result.responsesSize = 0;
+    asyncCommand.state = AsyncCommand::State::PENDING;
+    asyncCommand.step = AsyncCommand::Step::ADAPTER_COMMAND;
+    asyncCommand.isActive = true;
+
+    transferAsync(LINK_WIRELESS_DATA_REQUEST);
+  }
+
+  bool resumeAfterWait() {  // (irq only)
+    // (the clock control returns to the GBA)
+    linkSPI.activate(LinkSPI::Mode::MASTER_2MBPS);
+
+    u32 lines = 0;
+    u32 vCount = REG_VCOUNT;
+    while (linkSPI._isSIHigh()) {
+      if (timeout(LINK_WIRELESS_REVERSE_ACK_TIMEOUT, lines, vCount)) {
+        resetAsync();
+        setError(ACKNOWLEDGE_FAILED);
+        return false;
+      }
+    }
+
+    return true;
+  }
+#endif
+
+  void updateAsyncLobby() {  // (irq only)
+    if (asyncLobby.shouldEndSearch) {
+      asyncLobby.shouldEndSearch = false;
+
+      if (asyncLobby.isSearching) {
+        // Broadcast read end (start)
+        sendCommandAsync(LINK_WIRELESS_COMMAND_BROADCAST_READ_END);
+        return;
+      }
+    }
+
+    if (state == SEARCHING) {
+      if (!asyncLobby.isSearching) {
+        // Broadcast read start (start)
+        sendCommandAsync(LINK_WIRELESS_COMMAND_BROADCAST_READ_START);
+      } else if (asyncLobby.pollFrames >= LINK_WIRELESS_BROADCAST_POLL_FRAMES) {
+        // Broadcast read poll (start)
+        asyncLobby.pollFrames = 0;
+        sendCommandAsync(LINK_WIRELESS_COMMAND_BROADCAST_READ_POLL);
+      }
+    } else if (state == SERVING) {
+      if (!asyncLobby.didBroadcast) {
+        // Broadcast (start)
+        for (u32 i = 0; i < LINK_WIRELESS_BROADCAST_LENGTH; i++)
+          addData(asyncLobby.broadcastData[i], i == 0);
+        sendCommandAsync(LINK_WIRELESS_COMMAND_BROADCAST, true);
+      } else {
+        // Start host (start)
+        sendCommandAsync(LINK_WIRELESS_COMMAND_START_HOST);
+      }
+  } else if (state == CONNECTING) {
+      if (!asyncLobby.didRequestConnection) {
+        // Connect (start)
+        addData(asyncLobby.serverId, true);
+        sendCommandAsync(LINK_WIRELESS_COMMAND_CONNECT, true);
+      } else {
+        // Is finished connect (start)
+        sendCommandAsync(LINK_WIRELESS_COMMAND_IS_FINISHED_CONNECT);
+      }
+    }
+  }
+
   void acceptConnectionsOrSendData() {  // (irq only)
     if (state == SERVING && !sessionState.acceptCalled &&
         sessionState.playerCount < config.maxPlayers) {
@@ -780,6 +1740,14 @@ class LinkWireless {
       sendCommandAsync(LINK_WIRELESS_COMMAND_ACCEPT_CONNECTIONS);
       sessionState.acceptCalled = true;
     } else if (state == CONNECTED || isConnected()) {
+#if LINK_WIRELESS_USE_SEND_DATA_WAIT
+      if (state == CONNECTED) {
+        // Send data and wait (start)
+        sendPendingData(LINK_WIRELESS_COMMAND_SEND_DATA_WAIT);
+        return;
+      }
+#endif
+
       if (!sessionState.sendReceiveLatch || sessionState.shouldWaitForServer) {
         // Receive data (start)
         sendCommandAsync(LINK_WIRELESS_COMMAND_RECEIVE_DATA);
@@ -790,9 +1758,10 @@ class LinkWireless {
     }
   }
 
-  void sendPendingData() {  // (irq only)
+  void sendPendingData(
+      u8 command = LINK_WIRELESS_COMMAND_SEND_DATA) {  // (irq only)
     int lastPacketId = setDataFromOutgoingMessages();
-    sendCommandAsync(LINK_WIRELESS_COMMAND_SEND_DATA, true);
+    sendCommandAsync(command, true);
     clearOutgoingMessagesIfNeeded(lastPacketId);
   }
 
@@ -800,29 +1769,54 @@ class LinkWireless {
     u32 maxTransferLength = getDeviceTransferLength();
 
     addData(0, true);
+#if LINK_WIRELESS_USE_TRANSFER_CRC
+    addData(0);  // (it's filled at the end, and counts as transfer length)
+#endif
 
     if (config.retransmission)
       addConfirmations();
     else
       addPingMessageIfNeeded();
 
+#if LINK_WIRELESS_USE_DENSE_FRAMING
+    int lastPacketId = addOutgoingFrames(maxTransferLength);
+#else
     int lastPacketId = -1;
+    u32 packetId = sessionState.outgoingMessages.peekPacketId();
 
     sessionState.outgoingMessages.forEach(
-        [this, maxTransferLength, &lastPacketId](Message message) {
-          u16 header = buildMessageHeader(message.playerId, message.packetId,
-                                          buildChecksum(message.data));
-          u32 rawMessage = buildU32(header, message.data);
-
+        [this, maxTransferLength, &lastPacketId, &packetId](u32 rawMessage) {
           if (nextCommandDataSize /* -1 (wireless header) + 1 (rawMessage) */ >
               maxTransferLength)
             return false;
 
-          addData(rawMessage);
-          lastPacketId = message.packetId;
+          addData(updateClientCount(rawMessage));
+          lastPacketId = packetId++;
+          LINK_WIRELESS_STATS(stats().transferredMessages++);
 
           return true;
         });
+#endif
+
+#if LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS
+    if (config.retransmission && state == SERVING && isConnected() &&
+        nextCommandDataSize == LINK_WIRELESS_TRANSFER_HEADER_LENGTH) {
+      // (empty transfers refresh one connected client's confirmation, so
+      //  clients don't time out)
+      sessionState.lastRefreshedClient =
+          sessionState.lastRefreshedClient % (sessionState.playerCount - 1) + 1;
+      addClientConfirmation(sessionState.lastRefreshedClient);
+    }
+#endif
+
+#if LINK_WIRELESS_USE_TRANSFER_CRC
+    if (nextCommandDataSize == LINK_WIRELESS_TRANSFER_HEADER_LENGTH)
+      nextCommandDataSize = 1;  // (empty transfers don't need a CRC)
+    else
+      nextCommandData[1] = _buildTransferCRC(
+          nextCommandData + LINK_WIRELESS_TRANSFER_HEADER_LENGTH,
+          nextCommandDataSize - LINK_WIRELESS_TRANSFER_HEADER_LENGTH);
+#endif
 
     // (add wireless header)
     u32 bytes = (nextCommandDataSize - 1) * 4;
@@ -834,9 +1828,191 @@ class LinkWireless {
     return lastPacketId;
   }
 
+#if LINK_WIRELESS_USE_DENSE_FRAMING
+  int addOutgoingFrames(u32 maxTransferLength) {  // (irq only)
+    // (consecutive messages from the same player share a header word, which
+    //  contains the count and checksum of the payloads that follow it, two
+    //  per word)
+    int lastPacketId = -1;
+    u32 packetId = sessionState.outgoingMessages.peekPacketId();
+    OutgoingFrame frame;
+
+    sessionState.outgoingMessages.forEach([this, maxTransferLength,
+                                           &lastPacketId, &packetId,
+                                           &frame](u32 rawMessage) {
+      MessageHeaderSerializer serializer;
+      serializer.asInt = msB32(rawMessage);
+      u8 playerId = serializer.asStruct.playerId;
+      u16 data = lsB32(rawMessage);
+
+      bool isNewFrame = frame.count == 0 || playerId != frame.playerId;
+      u32 newWords = isNewFrame ? 2 : frame.count % 2 == 0;
+      if (nextCommandDataSize - 1 /* wireless header */ + newWords >
+          maxTransferLength)
+        return false;
+
+      if (isNewFrame) {
+        closeFrame(frame);
+        frame = OutgoingFrame{};
+        frame.headerIndex = nextCommandDataSize;
+        frame.packetId = packetId;
+        frame.playerId = playerId;
+        addData(0);
+      }
+
+      if (frame.count % 2 == 0)
+        addData(data);
+      else
+        nextCommandData[nextCommandDataSize - 1] |= data << 16;
+      frame.count++;
+      frame.checksum += __builtin_popcount(data);
+
+      lastPacketId = packetId++;
+      LINK_WIRELESS_STATS(stats().transferredMessages++);
+
+      return true;
+    });
+
+    closeFrame(frame);
+
+    return lastPacketId;
+  }
+
+  void closeFrame(OutgoingFrame& frame) {  // (irq only)
+    if (frame.count == 0)
+      return;
+
+    u16 info = frame.count | (frame.checksum << LINK_WIRELESS_FRAME_COUNT_BITS);
+    u16 header =
+        buildMessageHeader(frame.playerId, frame.packetId, buildChecksum(info));
+    nextCommandData[frame.headerIndex] = buildU32(header, info);
+  }
+#endif
+
   bool addIncomingMessagesFromData(CommandResult& result) {  // (irq only)
-    for (u32 i = 1; i < result.responsesSize; i++) {
-      u32 rawMessage = result.responses[i];
+    u32 starts[LINK_WIRELESS_MAX_PLAYERS];
+    u32 ends[LINK_WIRELESS_MAX_PLAYERS];
+    u32 transfers = findTransfers(result, starts, ends);
+#if LINK_WIRELESS_USE_TRANSFER_CRC
+    transfers = removeInvalidTransfers(result, starts, ends, transfers);
+#endif
+
+#if LINK_WIRELESS_USE_ISR_FORWARDING
+    if (isForwarding()) {
+      // (confirmations free slots in the outgoing queue, so the ones of every
+      //  client are handled before splitting the free slots between them)
+      for (u32 i = 0; i < transfers; i++)
+        starts[i] = addIncomingConfirmationsFromTransfer(result.responses,
+                                                         starts[i], ends[i]);
+      splitForwardingQuotas();
+    }
+#endif
+
+    // (the incoming queue can get full in the middle of a ReceiveData, so a
+    //  different client goes first each time, and late client ids aren't the
+    //  only ones that have to resend)
+    u32 first = transfers > 0 ? sessionState.receivingTurn % transfers : 0;
+    for (u32 i = 0; i < transfers; i++) {
+      u32 transfer = (first + i) % transfers;
+      addIncomingMessagesFromTransfer(result.responses, starts[transfer],
+                                      ends[transfer]);
+    }
+    if (transfers > 0)
+      sessionState.receivingTurn = (first + 1) % transfers;
+#if !LINK_WIRELESS_USE_ISR_FORWARDING
+    if (isForwarding())
+      grantOwnSlots();
+#endif
+
+    return true;
+  }
+
+  u32 findTransfers(CommandResult& result,
+                    u32* starts,
+                    u32* ends) {  // (irq only)
+    u32 transfers = 0;
+
+    if (state != SERVING) {
+      starts[0] = 1;
+      ends[0] = result.responsesSize;
+      return result.responsesSize > 1 ? 1 : 0;
+    }
+
+    // (servers receive all client transfers concatenated, in player id
+    //  order, and the wireless header has the byte count of each one)
+    u32 start = 1;
+    for (u32 i = 1; i < LINK_WIRELESS_MAX_PLAYERS; i++) {
+      u32 bytes = (result.responses[0] >> (3 + i * 5)) &
+                  LINK_WIRELESS_CLIENT_BYTES_MASK;
+      u32 end = std::min(start + bytes / 4, result.responsesSize);
+      if (end == start)
+        continue;
+
+      starts[transfers] = start;
+      ends[transfers] = end;
+      transfers++;
+      start = end;
+    }
+    if (start < result.responsesSize) {
+      // (words that the header doesn't count are read as one more transfer)
+      starts[transfers] = start;
+      ends[transfers] = result.responsesSize;
+      transfers++;
+    }
+
+    return transfers;
+  }
+
+#if LINK_WIRELESS_USE_TRANSFER_CRC
+  u32 removeInvalidTransfers(CommandResult& result,
+                             u32* starts,
+                             u32* ends,
+                             u32 transfers) {  // (irq only)
+    // (each transfer is checked on its own, so a corrupted one doesn't drop
+    //  the ones of the other clients)
+    u32 validTransfers = 0;
+    for (u32 i = 0; i < transfers; i++) {
+      u32 crc = result.responses[starts[i]];
+      u32 start = starts[i] + 1;
+      if (crc != _buildTransferCRC(result.responses + start, ends[i] - start)) {
+        LINK_WIRELESS_STATS(stats().invalidTransfers++);
+        continue;
+      }
+
+      starts[validTransfers] = start;
+      ends[validTransfers] = ends[i];
+      validTransfers++;
+    }
+
+    return validTransfers;
+  }
+#endif
+
+#if LINK_WIRELESS_USE_ISR_FORWARDING
+  u32 addIncomingConfirmationsFromTransfer(u32* transfer,
+                                           u32 start,
+                                           u32 end) {  // (irq only)
+    // (clients send their confirmation before their messages)
+    u32 i = start;
+    while (i < end && isConfirmationWord(transfer[i]))
+      i++;
+
+    addIncomingMessagesFromTransfer(transfer, start, i);
+    return i;
+  }
+
+  bool isConfirmationWord(u32 rawMessage) {  // (irq only)
+    MessageHeaderSerializer serializer;
+    serializer.asInt = msB32(rawMessage);
+    return serializer.asStruct.isConfirmation;
+  }
+#endif
+
+  void addIncomingMessagesFromTransfer(u32* transfer,
+                                       u32 start,
+                                       u32 end) {  // (irq only)
+    for (u32 i = start; i < end; i++) {
+      u32 rawMessage = transfer[i];
       u16 headerInt = msB32(rawMessage);
       u16 data = lsB32(rawMessage);
 
@@ -849,36 +2025,140 @@ class LinkWireless {
       u8 remotePlayerId = header.playerId;
       u8 remotePlayerCount = LINK_WIRELESS_MIN_PLAYERS + header.clientCount;
       u32 checksum = header.dataChecksum;
-      bool isPing = data == LINK_WIRELESS_MSG_PING;
 
       sessionState.timeouts[0] = 0;
       sessionState.timeouts[remotePlayerId] = 0;
 
-      if (checksum != buildChecksum(data))
+      if (checksum != buildChecksum(data)) {
+        LINK_WIRELESS_STATS(stats().invalidMessages++);
+#if LINK_WIRELESS_USE_DENSE_FRAMING
+        if (!isConfirmation)
+          break;  // (the frame length can't be trusted)
+#endif
         continue;
+      }
 
       Message message;
       message.packetId = partialPacketId;
       message.data = data;
       message.playerId = remotePlayerId;
 
-      if (!acceptMessage(message, isConfirmation, remotePlayerCount) || isPing)
-        continue;
+#if LINK_WIRELESS_USE_DENSE_FRAMING
+      if (!isConfirmation) {
+        u32 count = data & LINK_WIRELESS_FRAME_COUNT_MASK;
+        u32 payloadChecksum = data >> LINK_WIRELESS_FRAME_COUNT_BITS;
+        u32 words = (count + 1) / 2;
+        if (i + words >= end) {
+          LINK_WIRELESS_STATS(stats().invalidMessages++);
+          break;
+        }
 
-      if (config.retransmission && isConfirmation) {
-        if (!handleConfirmation(message))
+        u32* payloads = transfer + i + 1;
+        i += words;
+
+        u32 actualChecksum = 0;
+        for (u32 j = 0; j < words; j++)
+          actualChecksum += __builtin_popcount(payloads[j]);
+        if (actualChecksum != payloadChecksum) {
+          LINK_WIRELESS_STATS(stats().invalidMessages++);
           continue;
-      } else {
-        sessionState.tmpMessagesToReceive.push(message);
+        }
+
+        for (u32 j = 0; j < count; j++) {
+          message.packetId =
+              (partialPacketId + j) & LINK_WIRELESS_PACKET_ID_MASK;
+          message.data = j % 2 == 0 ? lsB32(payloads[j / 2])
+                                    : msB32(payloads[j / 2]);
+          message.playerId = remotePlayerId;
+          addIncomingMessage(message, false, remotePlayerCount);
+        }
+        continue;
       }
+#endif
+
+      addIncomingMessage(message, isConfirmation, remotePlayerCount);
     }
+  }
 
-    return true;
+  void addIncomingMessage(Message& message,
+                          bool isConfirmation,
+                          u32 remotePlayerCount) {  // (irq only)
+    bool isPing = message.data == LINK_WIRELESS_MSG_PING;
+
+#if LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS
+    if (state == SERVING && !isConfirmation)
+      sessionState.pendingConfirmations |= 1 << message.playerId;
+#endif
+
+
+    if (!acceptMessage(message, isConfirmation, remotePlayerCount)) {
+      LINK_WIRELESS_STATS(stats().ignoredMessages++);
+      return;
+    }
+    if (isPing)
+      return;
+
+    if (config.retransmission && isConfirmation) {
+      handleConfirmation(message);
+    } else {
+#if LINK_WIRELESS_USE_ISR_FORWARDING
+      forwardMessage(message);
+#endif
+      [[maybe_unused]] bool success = sessionState.tmpMessagesToReceive.push(
+          packMessage(message.packetId, message.data, message.playerId));
+      LINK_WIRELESS_STATS(countReceivedMessage(success, false));
+    }
+  }
+
+
+#if LINK_WIRELESS_USE_ISR_FORWARDING
+  void splitForwardingQuotas() {  // (irq only)
+    // (the free slots are split evenly, and the remainder goes to a different
+    //  client each time, so early client ids can't starve the others)
+    u32 clients = sessionState.playerCount - 1;
+    u32 freeSlots =
+        LINK_WIRELESS_QUEUE_SIZE - sessionState.outgoingMessages.size();
+    u32 share = freeSlots / clients;
+    u32 remainder = freeSlots % clients;
+    u32 first = sessionState.forwardingTurn % clients;
+
+    for (u32 i = 0; i < clients; i++) {
+      u32 turn = (i + clients - first) % clients;
+      sessionState.forwardingQuotas[1 + i] = share + (turn < remainder);
+    }
+    sessionState.forwardingTurn = (first + 1) % clients;
+  }
+
+  bool canForward(u8 playerId) {  // (irq only)
+    return !isForwarding() ||
+           (playerId < LINK_WIRELESS_MAX_PLAYERS &&
+            sessionState.forwardingQuotas[playerId] > 0);
+  }
+
+  void forwardMessage(Message& message) {  // (irq only)
+    if (!isForwarding())
+      return;
+    if (!canForward(message.playerId)) {
+      LINK_WIRELESS_STATS(stats().droppedOutgoingMessages++);
+      return;
+    }
+
+    sessionState.forwardingQuotas[message.playerId]--;
+    u32 packetId = newPacketId();
+    sessionState.outgoingMessages.push(
+        buildRawMessage(message.playerId, packetId, message.data), packetId);
+    LINK_WIRELESS_STATS(countQueuedMessage());
   }
+#endif
 
   bool acceptMessage(Message& message,
                      bool isConfirmation,
                      u32 remotePlayerCount) {  // (irq only)
+    if (config.retransmission && !isConfirmation &&
+        message.data != LINK_WIRELESS_MSG_PING &&
+        sessionState.tmpMessagesToReceive.isFull())
+      return false;  // (it will be sent again, instead of being dropped)
+
     if (state == SERVING) {
       u32 expectedPacketId =
           (sessionState.lastPacketIdFromClients[message.playerId] + 1) %
@@ -887,6 +2167,11 @@ class LinkWireless {
       if (config.retransmission && !isConfirmation &&
           message.packetId != expectedPacketId)
         return false;
+#if LINK_WIRELESS_USE_ISR_FORWARDING
+      if (config.retransmission && !isConfirmation &&
+          !canForward(message.playerId))
+        return false;  // (the client will send it again)
+#endif
 
       if (!isConfirmation)
         message.packetId =
@@ -918,22 +2203,29 @@ class LinkWireless {
 
   void addPingMessageIfNeeded() {  // (irq only)
     if (sessionState.outgoingMessages.isEmpty() && !sessionState.pingSent) {
-      Message pingMessage;
-      pingMessage.packetId = newPacketId();
-      pingMessage.playerId = sessionState.currentPlayerId;
-      pingMessage.data = LINK_WIRELESS_MSG_PING;
-      sessionState.outgoingMessages.push(pingMessage);
+      u32 packetId = newPacketId();
+      sessionState.outgoingMessages.push(
+          buildRawMessage(sessionState.currentPlayerId, packetId,
+                          LINK_WIRELESS_MSG_PING),
+          packetId);
       sessionState.pingSent = true;
     }
   }
 
   void addConfirmations() {  // (irq only)
     if (state == SERVING) {
-      if (config.maxPlayers > 2 &&
-          (sessionState.lastPacketIdFromClients[1] == 0 ||
-           sessionState.lastPacketIdFromClients[2] == 0 ||
-           sessionState.lastPacketIdFromClients[3] == 0 ||
-           sessionState.lastPacketIdFromClients[4] == 0)) {
+#if LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS
+      // (only until every connected client confirmed something)
+      bool isSyncNeeded = false;
+      for (u32 i = 1; i < sessionState.playerCount; i++)
+        isSyncNeeded |= sessionState.lastConfirmationFromClients[i] == 0;
+#else
+      bool isSyncNeeded = sessionState.lastPacketIdFromClients[1] == 0 ||
+                          sessionState.lastPacketIdFromClients[2] == 0 ||
+                          sessionState.lastPacketIdFromClients[3] == 0 ||
+                          sessionState.lastPacketIdFromClients[4] == 0;
+#endif
+      if (config.maxPlayers > 2 && isSyncNeeded) {
         u32 lastPacketId = sessionState.lastPacketId;
         u16 header = buildConfirmationHeader(0, lastPacketId);
         u32 rawMessage = buildU32(header, lastPacketId & 0xffff);
@@ -941,13 +2233,17 @@ class LinkWireless {
       }
 
       for (int i = 0; i < config.maxPlayers - 1; i++) {
-        u32 confirmationData = sessionState.lastPacketIdFromClients[1 + i];
-        u16 header = buildConfirmationHeader(1 + i, confirmationData);
-        u32 rawMessage = buildU32(header, confirmationData & 0xffff);
-        addData(rawMessage);
+#if LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS
+        if (!(sessionState.pendingConfirmations & (1 << (1 + i))))
+          continue;
+#endif
+        addClientConfirmation(1 + i);
       }
+#if LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS
+      sessionState.pendingConfirmations = 0;
+#endif
     } else {
-      u32 confirmationData = sessionState.lastPacketIdFromServer;
+      u32 confirmationData = buildConfirmationData(0);
       u16 header = buildConfirmationHeader(sessionState.currentPlayerId,
                                            confirmationData);
       u32 rawMessage = buildU32(header, confirmationData & 0xffff);
@@ -955,6 +2251,20 @@ class LinkWireless {
     }
   }
 
+  void addClientConfirmation(u8 playerId) {  // (irq only)
+    u32 confirmationData = buildConfirmationData(playerId);
+    u16 header = buildConfirmationHeader(playerId, confirmationData);
+    u32 rawMessage = buildU32(header, confirmationData & 0xffff);
+    addData(rawMessage);
+  }
+
+  u32 buildConfirmationData(u8 playerId) {  // (irq only)
+    u32 lastPacketId = playerId == 0
+                           ? sessionState.lastPacketIdFromServer
+                           : sessionState.lastPacketIdFromClients[playerId];
+    return lastPacketId;
+  }
+
   bool handleConfirmation(Message confirmation) {  // (irq only)
     u32 confirmationData = (confirmation.packetId << 16) | confirmation.data;
 
@@ -983,20 +2293,25 @@ class LinkWireless {
   void handleClientConfirmation(u32 confirmationData,
                                 u8 playerId) {  // (irq only)
     sessionState.lastConfirmationFromClients[playerId] = confirmationData;
+    sessionState.confirmingPlayers |= 1 << playerId;
 
+    // (a client that synced before the server's first message confirms 0,
+    //  so the clients that never confirmed are told apart with the bit mask)
     u32 min = 0xffffffff;
     for (int i = 0; i < config.maxPlayers - 1; i++) {
       u32 confirmationData = sessionState.lastConfirmationFromClients[1 + i];
-      if (confirmationData > 0 && confirmationData < min)
+      if ((sessionState.confirmingPlayers & (1 << (1 + i))) &&
+          confirmationData < min)
         min = confirmationData;
     }
     if (min < 0xffffffff)
       removeConfirmedMessages(min);
   }
 
+
   void removeConfirmedMessages(u32 confirmationData) {  // (irq only)
     while (!sessionState.outgoingMessages.isEmpty() &&
-           sessionState.outgoingMessages.peek().packetId <= confirmationData)
+           sessionState.outgoingMessages.peekPacketId() <= confirmationData)
       sessionState.outgoingMessages.pop();
   }
 
@@ -1010,10 +2325,11 @@ class LinkWireless {
     return buildMessageHeader(playerId, highPart, buildChecksum(lowPart), true);
   }
 
-  u16 buildMessageHeader(u8 playerId,
-                         u32 packetId,
-                         u8 dataChecksum,
-                         bool isConfirmation = false) {  // (irq only)
+  LINK_WIRELESS_IWRAM_CODE u16
+  buildMessageHeader(u8 playerId,
+                     u32 packetId,
+                     u8 dataChecksum,
+                     bool isConfirmation = false) {  // (irq only)
     MessageHeader header;
     header.partialPacketId = packetId % LINK_WIRELESS_MAX_PACKET_IDS;
     header.isConfirmation = isConfirmation;
@@ -1026,11 +2342,59 @@ class LinkWireless {
     return serializer.asInt;
   }
 
+  u32 buildRawMessage(u8 playerId, u32 packetId, u16 data) {  // (irq only)
+    u16 header = buildMessageHeader(playerId, packetId, buildChecksum(data));
+    return buildU32(header, data);
+  }
+
+  LINK_WIRELESS_IWRAM_CODE u32
+  updateClientCount(u32 rawMessage) {  // (irq only)
+    // (queued raw messages are reused across transfers, but the player
+    //  count can change in the meantime)
+    MessageHeaderSerializer serializer;
+    serializer.asInt = msB32(rawMessage);
+    serializer.asStruct.clientCount =
+        sessionState.playerCount - LINK_WIRELESS_MIN_PLAYERS;
+    return buildU32(serializer.asInt, lsB32(rawMessage));
+  }
+
+  static u32 packMessage(u32 packetId, u16 data, u8 playerId) {
+    // (data: 16 bits | playerId: 3 bits | low bits of packetId: 13 bits)
+    return data | ((playerId & 0b111) << 16) |
+           (packetId << LINK_WIRELESS_PACKED_ID_SHIFT);
+  }
+
+  Message unpackMessage(u32 packedMessage) {
+    Message message;
+    message.data = packedMessage & 0xffff;
+    message.playerId = (packedMessage >> 16) & 0b111;
+
+    // (the queues are much shorter than the packed id range, so the high bits
+    //  are recovered from the last packet id received from that player)
+    u32 lastPacketId =
+        state == SERVING
+            ? sessionState.lastPacketIdFromClients[message.playerId]
+            : sessionState.lastPacketIdFromServer;
+    u32 packedId = packedMessage >> LINK_WIRELESS_PACKED_ID_SHIFT;
+    u32 distance = (lastPacketId - packedId) & LINK_WIRELESS_PACKED_ID_MASK;
+    message.packetId = lastPacketId - distance;
+
+    return message;
+  }
+
   u32 buildChecksum(u16 data) {  // (irq only)
     // (hamming weight)
     return __builtin_popcount(data) % 16;
   }
 
+#if LINK_WIRELESS_USE_TRANSFER_CRC
+  static u32 updateCRC(u32 crc, u32 byte) {  // (irq only)
+    return ((crc << 8) ^ LINK_WIRELESS_CRC_TABLE.entries[((crc >> 8) ^ byte) &
+                                                         0xff]) &
+           0xffff;
+  }
+#endif
+
   void trackRemoteTimeouts() {  // (irq only)
     for (u32 i = 0; i < sessionState.playerCount; i++)
       if (i != sessionState.currentPlayerId)
@@ -1052,22 +2416,28 @@ class LinkWireless {
                             : LINK_WIRELESS_MAX_CLIENT_TRANSFER_LENGTH;
   }
 
-  void copyState() {  // (irq only)
+  LINK_WIRELESS_IWRAM_CODE void copyState() {  // (irq only)
     copyOutgoingState();
     copyIncomingState();
   }
 
-  void copyOutgoingState() {  // (irq only)
+  LINK_WIRELESS_IWRAM_CODE void copyOutgoingState() {  // (irq only)
     if (!isAddingMessage) {
       while (!sessionState.tmpMessagesToSend.isEmpty()) {
         if (isSessionActive() && !_canSend())
           break;
 
-        auto message = sessionState.tmpMessagesToSend.pop();
+        u32 packedMessage = sessionState.tmpMessagesToSend.pop();
 
         if (isSessionActive()) {
-          message.packetId = newPacketId();
-          sessionState.outgoingMessages.push(message);
+          u32 packetId = newPacketId();
+          sessionState.outgoingMessages.push(
+              buildRawMessage((packedMessage >> 16) & 0b111, packetId,
+                              packedMessage & 0xffff),
+              packetId);
+          LINK_WIRELESS_STATS(countQueuedMessage());
+        } else {
+          LINK_WIRELESS_STATS(stats().droppedOutgoingMessages++);
         }
       }
 
@@ -1078,13 +2448,18 @@ class LinkWireless {
     }
   }
 
-  void copyIncomingState() {  // (irq only)
+  LINK_WIRELESS_IWRAM_CODE void copyIncomingState() {  // (irq only)
     if (!isReadingMessages) {
       while (!sessionState.tmpMessagesToReceive.isEmpty()) {
-        auto message = sessionState.tmpMessagesToReceive.pop();
+        bool isActive = state == SERVING || state == CONNECTED;
+        if (isActive && sessionState.incomingMessages.isFull())
+          break;  // (with `retransmission`, new ones are refused meanwhile)
+
+        u32 packedMessage = sessionState.tmpMessagesToReceive.pop();
 
-        if (state == SERVING || state == CONNECTED)
-          sessionState.incomingMessages.push(message);
+        [[maybe_unused]] bool success =
+            isActive && sessionState.incomingMessages.push(packedMessage);
+        LINK_WIRELESS_STATS(countReceivedMessage(success, true));
       }
     }
   }
@@ -1100,32 +2475,103 @@ class LinkWireless {
     nextCommandDataSize++;
   }
 
-  void recoverName(std::string& name,
+  bool copyName(char* target, const char* source, u32 maxLength) {
+    u32 length = 0;
+    while (source[length] != '\0') {
+      if (length == maxLength)
+        return false;
+      target[length] = source[length];
+      length++;
+    }
+    while (length <= maxLength)
+      target[length++] = '\0';
+
+    return true;
+  }
+
+  void readServers(Server servers[]) {
+    LINK_WIRELESS_BARRIER;
+    isReadingServers = true;
+    LINK_WIRELESS_BARRIER;
+
+    u32 totalBroadcasts =
+        asyncLobby.broadcastsSize / LINK_WIRELESS_BROADCAST_RESPONSE_LENGTH;
+
+    for (u32 i = 0; i < totalBroadcasts; i++) {
+      u32 start = LINK_WIRELESS_BROADCAST_RESPONSE_LENGTH * i;
+      u32* broadcast = asyncLobby.broadcasts + start;
+
+      Server& server = servers[i];
+      server.id = (u16)broadcast[0];
+#if LINK_WIRELESS_USE_STD_STRING
+      char gameName[LINK_WIRELESS_MAX_GAME_NAME_LENGTH + 1];
+      char userName[LINK_WIRELESS_MAX_USER_NAME_LENGTH + 1];
+#else
+      char* gameName = server.gameName;
+      char* userName = server.userName;
+#endif
+      u32 gameNameLength = 0;
+      u32 userNameLength = 0;
+      recoverName(gameName, gameNameLength, broadcast[1], false);
+      recoverName(gameName, gameNameLength, broadcast[2]);
+      recoverName(gameName, gameNameLength, broadcast[3]);
+      recoverName(gameName, gameNameLength, broadcast[4]);
+      recoverName(userName, userNameLength, broadcast[5]);
+      recoverName(userName, userNameLength, broadcast[6]);
+#if LINK_WIRELESS_USE_STD_STRING
+      server.gameName = gameName;
+      server.userName = userName;
+#endif
+    }
+    if (totalBroadcasts < LINK_WIRELESS_MAX_SERVERS)
+      servers[totalBroadcasts].id = LINK_WIRELESS_END;
+
+    LINK_WIRELESS_BARRIER;
+    isReadingServers = false;
+    LINK_WIRELESS_BARRIER;
+  }
+
+  void recoverName(char* name,
+                   u32& nameLength,
                    u32 word,
                    bool includeFirstTwoBytes = true) {
     u32 character = 0;
     if (includeFirstTwoBytes) {
       character = lsB16(lsB32(word));
       if (character > 0)
-        name.push_back(character);
+        name[nameLength++] = character;
       character = msB16(lsB32(word));
       if (character > 0)
-        name.push_back(character);
+        name[nameLength++] = character;
     }
     character = lsB16(msB32(word));
     if (character > 0)
-      name.push_back(character);
+      name[nameLength++] = character;
     character = msB16(msB32(word));
     if (character > 0)
-      name.push_back(character);
+      name[nameLength++] = character;
+    name[nameLength] = '\0';
   }
 
   bool reset() {
+    LINK_WIRELESS_STATS(stats().resets++);
     resetState();
     stop();
     return start();
   }
 
+  void resetAsync(bool didStartFail = false) {
+    resetState();
+    stop();
+
+    // (if the adapter can't even start, give up until the next reset)
+    if (didStartFail)
+      return;
+
+    LINK_WIRELESS_STATS(stats().resets++);
+    startAsync();
+  }
+
   void resetState() {
     this->state = NEEDS_RESET;
     this->sessionState.playerCount = 1;
@@ -1144,12 +2590,39 @@ class LinkWireless {
       this->sessionState.timeouts[i] = 0;
       this->sessionState.lastPacketIdFromClients[i] = 0;
       this->sessionState.lastConfirmationFromClients[i] = 0;
+#if LINK_WIRELESS_USE_ISR_FORWARDING
+      this->sessionState.forwardingQuotas[i] = 0;
+#endif
     }
+    this->sessionState.confirmingPlayers = 0;
+    this->sessionState.receivingTurn = 0;
+#if !LINK_WIRELESS_USE_ISR_FORWARDING
+    this->sessionState.grantedOwnSlots = this->sessionState.usedOwnSlots;
+#endif
+#if LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS
+    this->sessionState.pendingConfirmations = 0;
+    this->sessionState.lastRefreshedClient = 0;
+#endif
+#if LINK_WIRELESS_USE_ISR_FORWARDING
+    this->sessionState.forwardingTurn = 0;
+#endif
     this->asyncCommand.isActive = false;
+    this->asyncLobby.isSearching = false;
+    this->asyncLobby.shouldEndSearch = false;
+    this->asyncLobby.didBroadcast = false;
+    this->asyncLobby.isHosting = false;
+    this->asyncLobby.didRequestConnection = false;
     this->nextCommandDataSize = 0;
 
-    if (!isReadingMessages)
+    if (!isReadingMessages) {
       this->sessionState.incomingMessages.clear();
+#if LINK_WIRELESS_ENABLE_BUFFERS
+      for (u32 i = 0; i < LINK_WIRELESS_MAX_PLAYERS; i++) {
+        incomingBuffers[i] = IncomingBuffer{};
+        readyBuffers[i].isReady = false;
+      }
+#endif
+    }
 
     isPendingClearActive = true;
   }
@@ -1157,14 +2630,14 @@ class LinkWireless {
   void stop() {
     stopTimer();
 
-    linkSPI->deactivate();
+    linkSPI.deactivate();
   }
 
   bool start() {
-    startTimer();
+    startTimer(config.interval);
 
     pingAdapter();
-    linkSPI->activate(LinkSPI::Mode::MASTER_256KBPS);
+    linkSPI.activate(LinkSPI::Mode::MASTER_256KBPS);
 
     if (!login())
       return false;
@@ -1178,31 +2651,101 @@ class LinkWireless {
     if (!sendCommand(LINK_WIRELESS_COMMAND_SETUP, true).success)
       return false;
 
-    linkSPI->activate(LinkSPI::Mode::MASTER_2MBPS);
+    linkSPI.activate(LinkSPI::Mode::MASTER_2MBPS);
     state = AUTHENTICATED;
 
     return true;
   }
 
+  void startAsync() {
+    // (the same steps as `start()`, but the waits are timer ticks and the
+    //  transfers complete on serial interrupts)
+    asyncStart = AsyncStart{};
+    startPing();
+
+    LINK_WIRELESS_BARRIER;
+    state = AUTHENTICATING;
+    LINK_WIRELESS_BARRIER;
+
+    startTimer(LINK_WIRELESS_ASYNC_START_INTERVAL);
+  }
+
+  void updateAsyncStart() {  // (irq only)
+    switch (asyncStart.step) {
+      case AsyncStart::Step::PING: {
+        asyncStart.pingTicks++;
+        if (asyncStart.pingTicks < LINK_WIRELESS_ASYNC_PING_TICKS)
+          return;
+
+        stopPing();
+        linkSPI.activate(LinkSPI::Mode::MASTER_256KBPS);
+        asyncStart.step = AsyncStart::Step::LOGIN;
+        break;
+      }
+      case AsyncStart::Step::LOGIN: {
+        if (linkSPI.getAsyncState() != LinkSPI::AsyncState::IDLE) {
+          // (the previous packet didn't arrive)
+          resetAsync(true);
+          setError(COMMAND_FAILED);
+          return;
+        }
+
+        transferAsync(buildLoginPacket(currentLoginPart(), asyncStart.memory),
+                      false);
+        break;
+      }
+      case AsyncStart::Step::HELLO: {
+        // Hello (start)
+        sendCommandAsync(LINK_WIRELESS_COMMAND_HELLO);
+        break;
+      }
+    }
+  }
+
+  void receiveLoginPacket(u32 response) {  // (irq only)
+    u16 expectedResponse = asyncStart.loginPackets > 0 ? currentLoginPart() : 0;
+    if (!checkLoginPacket(response, currentLoginPart(), expectedResponse,
+                          asyncStart.memory)) {
+      resetAsync(true);
+      setError(COMMAND_FAILED);
+      return;
+    }
+
+    asyncStart.loginPackets++;
+    if (asyncStart.loginPackets > LINK_WIRELESS_LOGIN_STEPS)
+      asyncStart.step = AsyncStart::Step::HELLO;
+  }
+
+  u16 currentLoginPart() {
+    u32 loginPackets = asyncStart.loginPackets;
+    return LINK_WIRELESS_LOGIN_PARTS[loginPackets > 0 ? loginPackets - 1 : 0];
+  }
+
   void stopTimer() {
     REG_TM[config.sendTimerId].cnt =
         REG_TM[config.sendTimerId].cnt & (~TM_ENABLE);
   }
 
-  void startTimer() {
-    REG_TM[config.sendTimerId].start = -config.interval;
+  void startTimer(u16 interval) {
+    REG_TM[config.sendTimerId].start = -interval;
     REG_TM[config.sendTimerId].cnt =
         TM_ENABLE | TM_IRQ | LINK_WIRELESS_BASE_FREQUENCY;
   }
 
   void pingAdapter() {
-    linkGPIO->setMode(LinkGPIO::Pin::SO, LinkGPIO::Direction::OUTPUT);
-    linkGPIO->setMode(LinkGPIO::Pin::SD, LinkGPIO::Direction::OUTPUT);
-    linkGPIO->writePin(LinkGPIO::SD, true);
+    startPing();
     wait(LINK_WIRELESS_PING_WAIT);
-    linkGPIO->writePin(LinkGPIO::SD, false);
+    stopPing();
+  }
+
+  void startPing() {
+    linkGPIO.setMode(LinkGPIO::Pin::SO, LinkGPIO::Direction::OUTPUT);
+    linkGPIO.setMode(LinkGPIO::Pin::SD, LinkGPIO::Direction::OUTPUT);
+    linkGPIO.writePin(LinkGPIO::SD, true);
   }
 
+  void stopPing() { linkGPIO.writePin(LinkGPIO::SD, false); }
+
   bool login() {
     LoginMemory memory;
 
@@ -1221,9 +2764,19 @@ class LinkWireless {
   bool exchangeLoginPacket(u16 data,
                            u16 expectedResponse,
                            LoginMemory& memory) {
-    u32 packet = buildU32(~memory.previousAdapterData, data);
-    u32 response = transfer(packet, false);
+    u32 response = transfer(buildLoginPacket(data, memory), false);
+
+    return checkLoginPacket(response, data, expectedResponse, memory);
+  }
+
+  u32 buildLoginPacket(u16 data, LoginMemory& memory) {
+    return buildU32(~memory.previousAdapterData, data);
+  }
 
+  bool checkLoginPacket(u32 response,
+                        u16 data,
+                        u16 expectedResponse,
+                        LoginMemory& memory) {
     if (msB32(response) != expectedResponse ||
         lsB32(response) != (u16)~memory.previousGBAData)
       return false;
@@ -1289,7 +2842,7 @@ class LinkWireless {
     transferAsync(command);
   }
 
-  void updateAsyncCommand(u32 newData) {  // (irq only)
+  LINK_WIRELESS_IWRAM_CODE void updateAsyncCommand(u32 newData) {  // (irq only)
     switch (asyncCommand.step) {
       case AsyncCommand::Step::COMMAND_HEADER: {
         if (newData != LINK_WIRELESS_DATA_REQUEST) {
@@ -1335,6 +2888,28 @@ class LinkWireless {
         receiveAsyncCommandResponseOrFinish();
         break;
       }
+      case AsyncCommand::Step::ADAPTER_COMMAND: {
+        u16 header = msB32(newData);
+        u8 event = lsB16(lsB32(newData));
+
+        if (header != LINK_WIRELESS_COMMAND_HEADER ||
+            (event != LINK_WIRELESS_EVENT_DATA_AVAILABLE &&
+             event != LINK_WIRELESS_EVENT_WAIT_TIMEOUT)) {
+          asyncCommand.state = AsyncCommand::State::COMPLETED;
+          return;
+        }
+
+        asyncCommand.result.responses[0] = event;
+        asyncCommand.result.responsesSize = 1;
+        asyncCommand.step = AsyncCommand::Step::ADAPTER_ACK;
+        transferAsync(buildCommand(event + LINK_WIRELESS_RESPONSE_ACK));
+        break;
+      }
+      case AsyncCommand::Step::ADAPTER_ACK: {
+        asyncCommand.result.success = true;
+        asyncCommand.state = AsyncCommand::State::COMPLETED;
+        break;
+      }
     }
   }
 
@@ -1363,9 +2938,9 @@ class LinkWireless {
     return buildU32(LINK_WIRELESS_COMMAND_HEADER, buildU16(length, type));
   }
 
-  void transferAsync(u32 data) {
-    linkSPI->transfer(
-        data, []() { return false; }, true, true);
+  void transferAsync(u32 data, bool customAck = true) {
+    linkSPI.transfer(
+        data, []() { return false; }, true, customAck);
   }
 
   u32 transfer(u32 data, bool customAck = true) {
@@ -1374,7 +2949,7 @@ class LinkWireless {
 
     u32 lines = 0;
     u32 vCount = REG_VCOUNT;
-    u32 receivedData = linkSPI->transfer(
+    u32 receivedData = linkSPI.transfer(
         data, [this, &lines, &vCount]() { return cmdTimeout(lines, vCount); },
         false, customAck);
 
@@ -1385,21 +2960,45 @@ class LinkWireless {
   }
 
   bool acknowledge() {
+#if LINK_WIRELESS_USE_SEND_DATA_WAIT
+    if (linkSPI.getMode() == LinkSPI::Mode::SLAVE)
+      return reverseAcknowledge();
+#endif
+
     u32 lines = 0;
     u32 vCount = REG_VCOUNT;
 
-    linkSPI->_setSOLow();
-    while (!linkSPI->_isSIHigh())
+    linkSPI._setSOLow();
+    while (!linkSPI._isSIHigh())
       if (cmdTimeout(lines, vCount))
         return false;
-    linkSPI->_setSOHigh();
-    while (linkSPI->_isSIHigh())
+    linkSPI._setSOHigh();
+    while (linkSPI._isSIHigh())
       if (cmdTimeout(lines, vCount))
         return false;
-    linkSPI->_setSOLow();
+    linkSPI._setSOLow();
+
+    return true;
+  }
+
+#if LINK_WIRELESS_USE_SEND_DATA_WAIT
+  bool reverseAcknowledge() {
+    // (during a Wait, the adapter controls the clock: the GBA goes high, the
+    //  adapter goes high, and the GBA goes low when the next transfer is
+    //  ready, which happens in `transfer(...)`)
+    // (this spins inside the serial IRQ, so it gives up after ~800μs, like
+    //  the adapter does, instead of the usual LINK_WIRELESS_CMD_TIMEOUT)
+    u32 lines = 0;
+    u32 vCount = REG_VCOUNT;
+
+    linkSPI._setSOHigh();
+    while (!linkSPI._isSIHigh())
+      if (timeout(LINK_WIRELESS_REVERSE_ACK_TIMEOUT, lines, vCount))
+        return false;
 
     return true;
   }
+#endif
 
   bool cmdTimeout(u32& lines, u32& vCount) {
     return timeout(LINK_WIRELESS_CMD_TIMEOUT, lines, vCount);
@@ -1453,16 +3052,43 @@ class LinkWireless {
 
 extern LinkWireless* linkWireless;
 
+#if LINK_WIRELESS_PUT_ISR_IN_IWRAM
+// (LinkWireless.iwram.cpp defines `linked` for its own options and class
+//  size, so compiling it with other LINK_WIRELESS_* options than the rest of
+//  the program fails to link, instead of breaking the ISRs at runtime)
+#define LINK_WIRELESS_IWRAM_OPTIONS                  \
+  ((!!LINK_WIRELESS_USE_STD_STRING << 0) |           \
+   (!!LINK_WIRELESS_USE_DENSE_FRAMING << 1) |        \
+   (!!LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS << 2) | \
+   (!!LINK_WIRELESS_USE_ISR_FORWARDING << 3) |       \
+   (!!LINK_WIRELESS_USE_TRANSFER_CRC << 4) |         \
+   (!!LINK_WIRELESS_USE_SEND_DATA_WAIT << 5) |       \
+   (!!LINK_WIRELESS_ENABLE_BUFFERS << 6) |           \
+   (!!LINK_WIRELESS_ENABLE_STATS << 7) |             \
+   (!!LINK_WIRELESS_ENABLE_PROFILER << 8))
+
+template <u32 SIZE, u32 OPTIONS>
+struct LinkWirelessIWRAMCheck {
+  static const u32 linked;
+};
+
+using LinkWirelessIWRAMConfig =
+    LinkWirelessIWRAMCheck<sizeof(LinkWireless), LINK_WIRELESS_IWRAM_OPTIONS>;
+
+__attribute__((used)) static const u32* LINK_WIRELESS_IWRAM_CHECK =
+    &LinkWirelessIWRAMConfig::linked;
+#else
 inline void LINK_WIRELESS_ISR_VBLANK() {
-  linkWireless->_onVBlank();
+  LINK_WIRELESS_PROFILE(WIRELESS_VBLANK, linkWireless->_onVBlank());
 }
 
 inline void LINK_WIRELESS_ISR_SERIAL() {
-  linkWireless->_onSerial();
+  LINK_WIRELESS_PROFILE(WIRELESS_SERIAL, linkWireless->_onSerial());
 }
 
 inline void LINK_WIRELESS_ISR_TIMER() {
-  linkWireless->_onTimer();
+  LINK_WIRELESS_PROFILE(WIRELESS_TIMER, linkWireless->_onTimer());
 }
+#endif
 
 #endif  // LINK_WIRELESS_H
@@ -0,0 +1,37 @@
+// --------------------------------------------------------------------------
+// LinkWireless' interrupt service routines, compiled as ARM code in IWRAM.
+// --------------------------------------------------------------------------
+// This file is only used when LINK_WIRELESS_PUT_ISR_IN_IWRAM is 1 (see
+// LinkWireless.h). The examples' Makefile compiles `*.iwram.cpp` files with
+// `-marm -mlong-calls` and links them in IWRAM, so the ISRs run without
+// ROM wait states (the methods they call are marked with
+// LINK_WIRELESS_IWRAM_CODE). Otherwise, it compiles to nothing.
+// --------------------------------------------------------------------------
+
+#include "LinkWireless.h"
+
+#if LINK_WIRELESS_PUT_ISR_IN_IWRAM
+
+// (weak, so programs that only use `LinkWireless::ISR<instance>` don't need to
+//  define the global `linkWireless` pointer)
+#pragma weak linkWireless
+
+// (see `LinkWirelessIWRAMCheck` in LinkWireless.h)
+template <u32 SIZE, u32 OPTIONS>
+const u32 LinkWirelessIWRAMCheck<SIZE, OPTIONS>::linked = 1;
+template struct LinkWirelessIWRAMCheck<sizeof(LinkWireless),
+                                       LINK_WIRELESS_IWRAM_OPTIONS>;
+
+void LINK_WIRELESS_ISR_VBLANK() {
+  LINK_WIRELESS_PROFILE(WIRELESS_VBLANK, linkWireless->_onVBlank());
+}
+
+void LINK_WIRELESS_ISR_SERIAL() {
+  LINK_WIRELESS_PROFILE(WIRELESS_SERIAL, linkWireless->_onSerial());
+}
+
+void LINK_WIRELESS_ISR_TIMER() {
+  LINK_WIRELESS_PROFILE(WIRELESS_TIMER, linkWireless->_onTimer());
+}
+
+#endif
@@ -0,0 +1,806 @@
+#ifndef LINK_HOST_BUS_H
+#define LINK_HOST_BUS_H
+
+// --------------------------------------------------------------------------
+// A host-side (PC) simulator of the Link Port, for testing and benchmarking.
+// --------------------------------------------------------------------------
+// It emulates 1~4 GBAs connected with a Link Cable, in a single thread:
+// - Multi-Play mode (16-bit), Normal mode (8/32-bit) and General Purpose mode
+// - REG_SIOCNT, REG_SIOMULTI, REG_SIOMLT_SEND, REG_SIODATA32 and REG_RCNT
+// - The four timers (including cascade), REG_VCOUNT and REG_KEYS
+// - VBLANK, TIMER and SERIAL interrupts
+// The library headers are compiled unmodified: `lib/host` provides its own
+// <tonc.h>, <tonc_core.h> and <tonc_bios.h>, which redirect every register
+// access to the simulated console that is currently running.
+// --------------------------------------------------------------------------
+// Usage:
+// - 1) Compile with `g++ -std=c++17 -I<path-to>/lib/host` and add:
+//       LinkHostBus* linkHostBus = new LinkHostBus(2);
+// - 2) Since there's only one `linkCable` global, swap it on every context
+//      switch (the bus switches consoles when delivering interrupts):
+//       LinkCable* cables[2];
+//       linkHostBus->setContextHandler([](u32 id) { linkCable = cables[id]; });
+// - 3) Initialize each console:
+//       linkHostBus->runOn(0, []() {
+//         irq_init(NULL);
+//         irq_add(II_VBLANK, LINK_CABLE_ISR_VBLANK);
+//         irq_add(II_SERIAL, LINK_CABLE_ISR_SERIAL);
+//         irq_add(II_TIMER3, LINK_CABLE_ISR_TIMER);
+//         linkCable->activate();
+//       });
+// - 4) Run your game loop body for N frames:
+//       linkHostBus->runFrames(60, [](u32 id) {
+//         linkCable->send(0x1234);
+//         // ...
+//         linkCable->consume();
+//       });
+//       // (the body runs once per console, and then the bus waits VBlank)
+// - 5) Inspect the results:
+//       LinkHostBus::Stats stats = linkHostBus->getStats(0);
+//       // (IRQ counts and cycles spent inside interrupt handlers)
+// --------------------------------------------------------------------------
+// considerations:
+// - everything is deterministic: time only advances when a console
+//   accesses an I/O register (`LINK_HOST_IO_CYCLES` each), when an IRQ is
+//   dispatched (`LINK_HOST_IRQ_CYCLES`), or when the bus waits for VBlank!
+// - so, cycle counts measure I/O traffic and interrupt overhead, not the
+//   arithmetic done by the handlers
+// - interrupts can only preempt code at I/O register accesses
+// - Normal and General Purpose modes connect consoles in pairs (0-1, 2-3)
+// - the BIOS' multiboot client is not emulated (`MultiBoot(...)` fails)
+// --------------------------------------------------------------------------
+
+#include <algorithm>
+
+typedef unsigned char u8;
+typedef unsigned short u16;
+typedef unsigned int u32;
+typedef unsigned long long u64;
+typedef signed char s8;
+typedef signed short s16;
+typedef signed int s32;
+typedef signed long long s64;
+typedef volatile u8 vu8;
+typedef volatile u16 vu16;
+typedef volatile u32 vu32;
+typedef volatile u64 vu64;
+typedef volatile s8 vs8;
+typedef volatile s16 vs16;
+typedef volatile s32 vs32;
+typedef volatile s64 vs64;
+
+#define LINK_HOST_MAX_CONSOLES 4
+#define LINK_HOST_CPU_FREQUENCY 16777216
+#define LINK_HOST_CYCLES_PER_LINE 1232
+#define LINK_HOST_TOTAL_LINES 228
+#define LINK_HOST_VBLANK_LINE 160
+#define LINK_HOST_CYCLES_PER_FRAME \
+  (LINK_HOST_CYCLES_PER_LINE * LINK_HOST_TOTAL_LINES)
+#define LINK_HOST_IO_CYCLES 4
+#define LINK_HOST_IRQ_CYCLES 64
+#define LINK_HOST_TOTAL_IRQS 14
+#define LINK_HOST_MULTIPLAY_BITS_PER_UNIT 18
+#define LINK_HOST_NO_EVENT 0xffffffffffffffff
+#define LINK_HOST_REG_VCOUNT 0x006
+#define LINK_HOST_REG_TM 0x100
+#define LINK_HOST_REG_SIOMULTI 0x120
+#define LINK_HOST_REG_SIODATA32 0x120
+#define LINK_HOST_REG_SIOCNT 0x128
+#define LINK_HOST_REG_SIOMLT_SEND 0x12a
+#define LINK_HOST_REG_KEYS 0x130
+#define LINK_HOST_REG_RCNT 0x134
+#define LINK_HOST_BIT_CLOCK 0
+#define LINK_HOST_BIT_CLOCK_SPEED 1
+#define LINK_HOST_BIT_SI 2
+#define LINK_HOST_BIT_SO 3
+#define LINK_HOST_BIT_SD 3
+#define LINK_HOST_BITS_PLAYER_ID 4
+#define LINK_HOST_BIT_START 7
+#define LINK_HOST_BIT_SI_INTERRUPT 8
+#define LINK_HOST_BIT_LENGTH 12
+#define LINK_HOST_BIT_MULTIPLAYER 13
+#define LINK_HOST_BIT_IRQ 14
+#define LINK_HOST_BIT_GENERAL_PURPOSE_LOW 14
+#define LINK_HOST_BIT_GENERAL_PURPOSE_HIGH 15
+#define LINK_HOST_BIT_TIMER_CASCADE 2
+#define LINK_HOST_BIT_TIMER_IRQ 6
+#define LINK_HOST_BIT_TIMER_ENABLE 7
+#define LINK_HOST_IRQ_VBLANK 0
+#define LINK_HOST_IRQ_TIMER0 3
+#define LINK_HOST_IRQ_SERIAL 7
+#define LINK_HOST_GET(REG, BIT) (((REG) >> (BIT)) & 1)
+
+static volatile char LINK_HOST_BUS_VERSION[] = "LinkHostBus/v5.0.2";
+
+const u32 LINK_HOST_BAUD_RATES[] = {9600, 38400, 57600, 115200};
+const u32 LINK_HOST_TIMER_SHIFTS[] = {0, 6, 8, 10};
+const u8 LINK_HOST_WIRED_PINS[] = {0, 1, 3, 2};  // SC-SC, SD-SD, SI-SO, SO-SI
+
+class LinkHostBus {
+ public:
+  enum Mode {
+    NORMAL_8BIT,
+    NORMAL_32BIT,
+    MULTIPLAY,
+    UART,
+    GENERAL_PURPOSE,
+    JOYBUS
+  };
+  typedef void (*IRQHandler)();
+  typedef void (*ContextHandler)(u32 consoleId);
+
+  struct Stats {
+    u32 irqs[LINK_HOST_TOTAL_IRQS];
+    u64 irqCycles;
+    u32 transfers;
+  };
+
+  explicit LinkHostBus(u32 consoles = 2) {
+    this->totalConsoles =
+        std::min(std::max(consoles, (u32)1), (u32)LINK_HOST_MAX_CONSOLES);
+  }
+
+  u32 consoleCount() { return totalConsoles; }
+  u32 currentConsole() { return currentId; }
+  u64 getCycles() { return cycles; }
+  u32 getFrame() { return cycles / LINK_HOST_CYCLES_PER_FRAME; }
+
+  void setContextHandler(ContextHandler handler) {
+    contextHandler = handler;
+    if (contextHandler)
+      contextHandler(currentId);
+  }
+
+  void setConnected(u32 consoleId, bool isConnected) {
+    consoles[consoleId].isConnected = isConnected;
+  }
+  bool isConnected(u32 consoleId) { return consoles[consoleId].isConnected; }
+  Mode getMode(u32 consoleId) { return mode(consoles[consoleId]); }
+
+  // (a peripheral, like a simulated Wireless Adapter, reacts instantly: its
+  //  I/O and IRQs take no time, so its handlers can't be preempted by a
+  //  console that busy-waits for them)
+  void setPeripheral(u32 consoleId, bool isPeripheral) {
+    consoles[consoleId].isPeripheral = isPeripheral;
+  }
+
+  void setKeys(u32 consoleId, u16 pressedKeys) {
+    consoles[consoleId].keys = ~pressedKeys & 0x3ff;
+  }
+
+  Stats getStats(u32 consoleId) { return consoles[consoleId].stats; }
+  void resetStats() {
+    for (u32 i = 0; i < LINK_HOST_MAX_CONSOLES; i++)
+      consoles[i].stats = Stats{};
+  }
+
+  template <typename F>
+  void runOn(u32 consoleId, F action) {
+    u32 previousId = switchTo(consoleId);
+    action();
+    switchTo(previousId);
+  }
+
+  template <typename F>
+  void runFrames(u32 frames, F body) {
+    for (u32 frame = 0; frame < frames; frame++) {
+      for (u32 i = 0; i < totalConsoles; i++)
+        runOn(i, [&body, i]() { body(i); });
+
+      waitVBlank();
+    }
+  }
+
+  void waitVBlank() { advanceTo(nextVBlank); }
+  void wait(u32 cycles) { advanceTo(this->cycles + cycles); }
+
+  u16 _read16(u32 address) {
+    if (!consoles[currentId].isPeripheral)
+      wait(LINK_HOST_IO_CYCLES);
+    Console& console = consoles[currentId];
+
+    switch (address) {
+      case LINK_HOST_REG_VCOUNT:
+        return (cycles % LINK_HOST_CYCLES_PER_FRAME) /
+               LINK_HOST_CYCLES_PER_LINE;
+      case LINK_HOST_REG_SIOCNT:
+        return readSIOCNT(currentId);
+      case LINK_HOST_REG_SIOMLT_SEND:
+        return console.siomltSend;
+      case LINK_HOST_REG_KEYS:
+        return console.keys;
+      case LINK_HOST_REG_RCNT:
+        return readRCNT(currentId);
+      default: {
+        if (address >= LINK_HOST_REG_SIOMULTI &&
+            address < LINK_HOST_REG_SIOMULTI + 8)
+          return console.siomulti[(address - LINK_HOST_REG_SIOMULTI) / 2];
+        if (address >= LINK_HOST_REG_TM && address < LINK_HOST_REG_TM + 16) {
+          u32 timerId = (address - LINK_HOST_REG_TM) / 4;
+          return address % 4 == 0 ? timerValue(console, timerId)
+                                  : console.timers[timerId].control;
+        }
+        return 0;
+      }
+    }
+  }
+
+  void _write16(u32 address, u16 value) {
+    if (!consoles[currentId].isPeripheral)
+      wait(LINK_HOST_IO_CYCLES);
+    Console& console = consoles[currentId];
+
+    switch (address) {
+      case LINK_HOST_REG_SIOCNT: {
+        writeSIOCNT(currentId, value);
+        break;
+      }
+      case LINK_HOST_REG_SIOMLT_SEND: {
+        console.siomltSend = value;
+        break;
+      }
+      case LINK_HOST_REG_RCNT: {
+        writeRCNT(currentId, value);
+        break;
+      }
+      default: {
+        if (address >= LINK_HOST_REG_SIOMULTI &&
+            address < LINK_HOST_REG_SIOMULTI + 4)
+          console.siomulti[(address - LINK_HOST_REG_SIOMULTI) / 2] = value;
+        if (address >= LINK_HOST_REG_TM && address < LINK_HOST_REG_TM + 16) {
+          u32 timerId = (address - LINK_HOST_REG_TM) / 4;
+          if (address % 4 == 0)
+            console.timers[timerId].reload = value;
+          else
+            writeTimerControl(console, timerId, value);
+        }
+      }
+    }
+  }
+
+  u32 _read32(u32 address) {
+    return _read16(address) | (_read16(address + 2) << 16);
+  }
+
+  void _write32(u32 address, u32 value) {
+    _write16(address, value & 0xffff);
+    _write16(address + 2, value >> 16);
+  }
+
+  void _setIRQHandler(u32 index, IRQHandler handler) {
+    Console& console = consoles[currentId];
+    console.handlers[index] = handler;
+    if (handler)
+      console.irqEnable |= 1 << index;
+    else
+      console.irqEnable &= ~(1 << index);
+  }
+
+  void _resetIRQHandlers() {
+    for (u32 i = 0; i < LINK_HOST_TOTAL_IRQS; i++)
+      _setIRQHandler(i, nullptr);
+  }
+
+ private:
+  struct Timer {
+    u16 reload = 0;
+    u16 control = 0;
+    u16 startValue = 0;
+    u64 base = 0;
+  };
+
+  struct Console {
+    bool isConnected = true;
+    u16 siocnt = 0;
+    u16 rcnt = 0;
+    u16 siomulti[LINK_HOST_MAX_CONSOLES] = {};
+    u16 siomltSend = 0;
+    u16 keys = 0x3ff;
+    u8 playerId = 0;
+    bool isTransferring = false;
+    bool isArmed = false;
+    Mode transferMode = MULTIPLAY;
+    u64 transferEnd = LINK_HOST_NO_EVENT;
+    Timer timers[4];
+    IRQHandler handlers[LINK_HOST_TOTAL_IRQS] = {};
+    u16 irqEnable = 0;
+    u16 irqFlags = 0;
+    bool isInIRQ = false;
+    bool isPeripheral = false;
+    Stats stats = {};
+  };
+
+  Console consoles[LINK_HOST_MAX_CONSOLES];
+  u32 totalConsoles;
+  u32 currentId = 0;
+  u64 cycles = 0;
+  u64 nextVBlank = LINK_HOST_VBLANK_LINE * LINK_HOST_CYCLES_PER_LINE;
+  u64 totalIRQCycles = 0;
+  ContextHandler contextHandler = nullptr;
+
+  // --- Scheduler ---
+
+  void advanceTo(u64 target) {
+    while (true) {
+      u64 next = nextEventTime();
+      if (next > target)
+        break;
+
+      cycles = std::max(cycles, next);
+      processEvents();
+      dispatchIRQs();
+    }
+
+    cycles = std::max(cycles, target);
+  }
+
+  u64 nextEventTime() {
+    u64 next = nextVBlank;
+
+    for (u32 i = 0; i < totalConsoles; i++) {
+      Console& console = consoles[i];
+      next = std::min(next, console.transferEnd);
+      for (u32 t = 0; t < 4; t++)
+        next = std::min(next, timerOverflowTime(console, t));
+    }
+
+    return next;
+  }
+
+  void processEvents() {
+    if (nextVBlank <= cycles) {
+      nextVBlank += LINK_HOST_CYCLES_PER_FRAME;
+      for (u32 i = 0; i < totalConsoles; i++)
+        raiseIRQ(i, LINK_HOST_IRQ_VBLANK);
+    }
+
+    for (u32 i = 0; i < totalConsoles; i++) {
+      Console& console = consoles[i];
+
+      for (u32 t = 0; t < 4; t++) {
+        u64 overflowTime = timerOverflowTime(console, t);
+        if (overflowTime <= cycles) {
+          console.timers[t].startValue = console.timers[t].reload;
+          console.timers[t].base = overflowTime;
+          overflowTimer(i, t);
+        }
+      }
+
+      if (console.transferEnd <= cycles) {
+        console.transferEnd = LINK_HOST_NO_EVENT;
+        if (console.transferMode == MULTIPLAY)
+          finishMultiplayTransfer();
+        else
+          finishNormalTransfer(i);
+      }
+    }
+  }
+
+  void dispatchIRQs() {
+    bool didDispatch;
+
+    do {
+      didDispatch = false;
+
+      for (u32 i = 0; i < totalConsoles; i++) {
+        Console& console = consoles[i];
+        u16 pending = console.irqFlags & console.irqEnable;
+        if (console.isInIRQ || pending == 0)
+          continue;
+
+        u32 index = __builtin_ctz(pending);
+        console.irqFlags &= ~(1 << index);
+        runHandler(i, index);
+        didDispatch = true;
+      }
+    } while (didDispatch);
+  }
+
+  void runHandler(u32 consoleId, u32 index) {
+    Console& console = consoles[consoleId];
+    u64 startCycles = cycles;
+    u64 startTotalIRQCycles = totalIRQCycles;
+
+    u32 previousId = switchTo(consoleId);
+    console.isInIRQ = true;
+    if (!console.isPeripheral)
+      wait(LINK_HOST_IRQ_CYCLES);
+    console.handlers[index]();
+    console.isInIRQ = false;
+    switchTo(previousId);
+
+    u64 nestedCycles = totalIRQCycles - startTotalIRQCycles;
+    u64 ownCycles = (cycles - startCycles) - nestedCycles;
+    totalIRQCycles += ownCycles;
+    console.stats.irqCycles += ownCycles;
+    console.stats.irqs[index]++;
+  }
+
+  void raiseIRQ(u32 consoleId, u32 index) {
+    Console& console = consoles[consoleId];
+    if (console.irqEnable & (1 << index))
+      console.irqFlags |= 1 << index;
+  }
+
+  u32 switchTo(u32 consoleId) {
+    u32 previousId = currentId;
+    currentId = consoleId;
+    if (contextHandler && previousId != consoleId)
+      contextHandler(consoleId);
+    return previousId;
+  }
+
+  // --- Timers ---
+
+  u64 timerOverflowTime(Console& console, u32 timerId) {
+    Timer& timer = console.timers[timerId];
+    if (!LINK_HOST_GET(timer.control, LINK_HOST_BIT_TIMER_ENABLE) ||
+        isCascade(timer, timerId))
+      return LINK_HOST_NO_EVENT;
+
+    u32 shift = LINK_HOST_TIMER_SHIFTS[timer.control & 0b11];
+    return timer.base + ((u64)(0x10000 - timer.startValue) << shift);
+  }
+
+  u16 timerValue(Console& console, u32 timerId) {
+    Timer& timer = console.timers[timerId];
+    if (!LINK_HOST_GET(timer.control, LINK_HOST_BIT_TIMER_ENABLE) ||
+        isCascade(timer, timerId))
+      return timer.startValue;
+
+    u32 shift = LINK_HOST_TIMER_SHIFTS[timer.control & 0b11];
+    return timer.startValue + ((cycles - timer.base) >> shift);
+  }
+
+  void writeTimerControl(Console& console, u32 timerId, u16 value) {
+    Timer& timer = console.timers[timerId];
+    bool wasEnabled = LINK_HOST_GET(timer.control, LINK_HOST_BIT_TIMER_ENABLE);
+    bool isEnabled = LINK_HOST_GET(value, LINK_HOST_BIT_TIMER_ENABLE);
+
+    if (wasEnabled)
+      timer.startValue = timerValue(console, timerId);
+    if (!wasEnabled && isEnabled)
+      timer.startValue = timer.reload;
+
+    timer.base = cycles;
+    timer.control = value;
+  }
+
+  void overflowTimer(u32 consoleId, u32 timerId) {
+    Console& console = consoles[consoleId];
+    Timer& timer = console.timers[timerId];
+
+    if (LINK_HOST_GET(timer.control, LINK_HOST_BIT_TIMER_IRQ))
+      raiseIRQ(consoleId, LINK_HOST_IRQ_TIMER0 + timerId);
+
+    if (timerId == 3)
+      return;
+
+    Timer& nextTimer = console.timers[timerId + 1];
+    if (LINK_HOST_GET(nextTimer.control, LINK_HOST_BIT_TIMER_ENABLE) &&
+        isCascade(nextTimer, timerId + 1)) {
+      nextTimer.startValue++;
+      if (nextTimer.startValue == 0) {
+        nextTimer.startValue = nextTimer.reload;
+        overflowTimer(consoleId, timerId + 1);
+      }
+    }
+  }
+
+  bool isCascade(Timer& timer, u32 timerId) {
+    return timerId > 0 &&
+           LINK_HOST_GET(timer.control, LINK_HOST_BIT_TIMER_CASCADE);
+  }
+
+  // --- Serial ---
+
+  Mode mode(Console& console) {
+    if (LINK_HOST_GET(console.rcnt, LINK_HOST_BIT_GENERAL_PURPOSE_HIGH))
+      return LINK_HOST_GET(console.rcnt, LINK_HOST_BIT_GENERAL_PURPOSE_LOW)
+                 ? JOYBUS
+                 : GENERAL_PURPOSE;
+    if (LINK_HOST_GET(console.siocnt, LINK_HOST_BIT_MULTIPLAYER))
+      return LINK_HOST_GET(console.siocnt, LINK_HOST_BIT_LENGTH) ? UART
+                                                                 : MULTIPLAY;
+    return LINK_HOST_GET(console.siocnt, LINK_HOST_BIT_LENGTH) ? NORMAL_32BIT
+                                                               : NORMAL_8BIT;
+  }
+
+  bool isNormal(Console& console) {
+    return mode(console) == NORMAL_8BIT || mode(console) == NORMAL_32BIT;
+  }
+
+  bool isMultiplayMaster(u32 consoleId) {
+    for (u32 i = 0; i < consoleId; i++)
+      if (consoles[i].isConnected)
+        return false;
+    return true;
+  }
+
+  bool isMultiplayReady() {
+    for (u32 i = 0; i < totalConsoles; i++) {
+      Console& console = consoles[i];
+      if (console.isConnected && mode(console) != MULTIPLAY)
+        return false;
+    }
+    return true;
+  }
+
+  u32 peerOf(u32 consoleId) { return consoleId ^ 1; }
+
+  bool hasPeer(u32 consoleId) {
+    u32 peerId = peerOf(consoleId);
+    return peerId < totalConsoles && consoles[consoleId].isConnected &&
+           consoles[peerId].isConnected;
+  }
+
+  u16 readSIOCNT(u32 consoleId) {
+    Console& console = consoles[consoleId];
+
+    switch (mode(console)) {
+      case MULTIPLAY: {
+        bool isSlave = !console.isConnected || !isMultiplayMaster(consoleId);
+        bool isReady = console.isConnected && isMultiplayReady();
+        return (console.siocnt & ~0b11111100) | (isSlave << LINK_HOST_BIT_SI) |
+               (isReady << LINK_HOST_BIT_SD) |
+               (console.playerId << LINK_HOST_BITS_PLAYER_ID) |
+               (console.isTransferring << LINK_HOST_BIT_START);
+      }
+      case NORMAL_8BIT:
+      case NORMAL_32BIT: {
+        bool isBusy = console.isTransferring || console.isArmed;
+        return (console.siocnt & ~0b10000100) |
+               (readNormalSI(consoleId) << LINK_HOST_BIT_SI) |
+               (isBusy << LINK_HOST_BIT_START);
+      }
+      default:
+        return console.siocnt;
+    }
+  }
+
+  void writeSIOCNT(u32 consoleId, u16 value) {
+    Console& console = consoles[consoleId];
+    bool wantsStart = LINK_HOST_GET(value, LINK_HOST_BIT_START);
+    console.siocnt = value;
+
+    switch (mode(console)) {
+      case MULTIPLAY: {
+        if (wantsStart && !console.isTransferring && console.isConnected &&
+            isMultiplayMaster(consoleId) && isMultiplayReady())
+          startMultiplayTransfer(consoleId);
+        break;
+      }
+      case NORMAL_8BIT:
+      case NORMAL_32BIT: {
+        bool isMaster = LINK_HOST_GET(value, LINK_HOST_BIT_CLOCK);
+
+        if (!wantsStart) {
+          console.isArmed = false;
+          if (console.transferMode != MULTIPLAY) {
+            console.isTransferring = false;
+            console.transferEnd = LINK_HOST_NO_EVENT;
+          }
+        } else if (!isMaster) {
+          console.isArmed = true;
+        } else if (!console.isTransferring) {
+          startNormalTransfer(consoleId);
+        }
+        break;
+      }
+      default: {
+      }
+    }
+  }
+
+  void startMultiplayTransfer(u32 masterId) {
+    u32 participants = 0;
+    for (u32 i = 0; i < totalConsoles; i++) {
+      if (consoles[i].isConnected) {
+        consoles[i].isTransferring = true;
+        participants++;
+      }
+    }
+
+    u32 baudRate = LINK_HOST_BAUD_RATES[consoles[masterId].siocnt & 0b11];
+    consoles[masterId].transferMode = MULTIPLAY;
+    consoles[masterId].transferEnd =
+        cycles + (u64)participants * LINK_HOST_MULTIPLAY_BITS_PER_UNIT *
+                     LINK_HOST_CPU_FREQUENCY / baudRate;
+  }
+
+  void finishMultiplayTransfer() {
+    u16 data[LINK_HOST_MAX_CONSOLES];
+    u32 participants = 0;
+    for (u32 i = 0; i < totalConsoles; i++) {
+      Console& console = consoles[i];
+      if (console.isConnected && mode(console) == MULTIPLAY)
+        data[participants++] = console.siomltSend;
+    }
+    for (u32 i = participants; i < LINK_HOST_MAX_CONSOLES; i++)
+      data[i] = 0xffff;
+
+    u32 playerId = 0;
+    for (u32 i = 0; i < totalConsoles; i++) {
+      Console& console = consoles[i];
+      console.isTransferring = false;
+      if (!console.isConnected || mode(console) != MULTIPLAY)
+        continue;
+
+      for (u32 j = 0; j < LINK_HOST_MAX_CONSOLES; j++)
+        console.siomulti[j] = data[j];
+      console.playerId = playerId++;
+      console.stats.transfers++;
+
+      if (LINK_HOST_GET(console.siocnt, LINK_HOST_BIT_IRQ))
+        raiseIRQ(i, LINK_HOST_IRQ_SERIAL);
+    }
+  }
+
+  void startNormalTransfer(u32 masterId) {
+    Console& console = consoles[masterId];
+    u32 bits = mode(console) == NORMAL_32BIT ? 32 : 8;
+    u32 cyclesPerBit =
+        LINK_HOST_GET(console.siocnt, LINK_HOST_BIT_CLOCK_SPEED) ? 8 : 64;
+
+    console.isTransferring = true;
+    console.transferMode = mode(console);
+    console.transferEnd = cycles + bits * cyclesPerBit;
+  }
+
+  void finishNormalTransfer(u32 masterId) {
+    Console& master = consoles[masterId];
+    bool is32Bit = mode(master) == NORMAL_32BIT;
+    u32 peerId = peerOf(masterId);
+    bool isPeerReady = hasPeer(masterId) && isNormal(consoles[peerId]) &&
+                       consoles[peerId].isArmed;
+
+    u32 masterData = readNormalData(master, is32Bit);
+    u32 slaveData = is32Bit ? 0xffffffff : 0xff;
+    if (isPeerReady) {
+      Console& slave = consoles[peerId];
+      slaveData = readNormalData(slave, is32Bit);
+      writeNormalData(slave, masterData, is32Bit);
+      slave.isArmed = false;
+      slave.stats.transfers++;
+      if (LINK_HOST_GET(slave.siocnt, LINK_HOST_BIT_IRQ))
+        raiseIRQ(peerId, LINK_HOST_IRQ_SERIAL);
+    }
+
+    writeNormalData(master, slaveData, is32Bit);
+    master.isTransferring = false;
+    master.stats.transfers++;
+    if (LINK_HOST_GET(master.siocnt, LINK_HOST_BIT_IRQ))
+      raiseIRQ(masterId, LINK_HOST_IRQ_SERIAL);
+  }
+
+  u32 readNormalData(Console& console, bool is32Bit) {
+    return is32Bit ? console.siomulti[0] | (console.siomulti[1] << 16)
+                   : console.siomltSend & 0xff;
+  }
+
+  void writeNormalData(Console& console, u32 data, bool is32Bit) {
+    if (is32Bit) {
+      console.siomulti[0] = data & 0xffff;
+      console.siomulti[1] = data >> 16;
+    } else {
+      console.siomltSend = (console.siomltSend & 0xff00) | (data & 0xff);
+    }
+  }
+
+  bool readNormalSI(u32 consoleId) {
+    if (!hasPeer(consoleId))
+      return true;
+
+    Console& peer = consoles[peerOf(consoleId)];
+    return !isNormal(peer) || LINK_HOST_GET(peer.siocnt, LINK_HOST_BIT_SO);
+  }
+
+  // --- General Purpose ---
+
+  u16 readRCNT(u32 consoleId) {
+    Console& console = consoles[consoleId];
+    if (mode(console) != GENERAL_PURPOSE)
+      return console.rcnt;
+
+    u16 value = console.rcnt & ~0b1111;
+    for (u32 pin = 0; pin < 4; pin++)
+      value |= readPin(consoleId, pin) << pin;
+    return value;
+  }
+
+  void writeRCNT(u32 consoleId, u16 value) {
+    bool previousSI[LINK_HOST_MAX_CONSOLES];
+    for (u32 i = 0; i < totalConsoles; i++)
+      previousSI[i] = readPin(i, LINK_HOST_BIT_SI);
+
+    consoles[consoleId].rcnt = value;
+
+    for (u32 i = 0; i < totalConsoles; i++) {
+      Console& console = consoles[i];
+      bool didFall = previousSI[i] && !readPin(i, LINK_HOST_BIT_SI);
+      if (didFall && mode(console) == GENERAL_PURPOSE &&
+          LINK_HOST_GET(console.rcnt, LINK_HOST_BIT_SI_INTERRUPT))
+        raiseIRQ(i, LINK_HOST_IRQ_SERIAL);
+    }
+  }
+
+  bool readPin(u32 consoleId, u32 pin) {
+    Console& console = consoles[consoleId];
+    if (LINK_HOST_GET(console.rcnt, 4 + pin))
+      return LINK_HOST_GET(console.rcnt, pin);
+    if (!hasPeer(consoleId))
+      return true;
+
+    Console& peer = consoles[peerOf(consoleId)];
+    u32 peerPin = LINK_HOST_WIRED_PINS[pin];
+    bool isDriven = mode(peer) == GENERAL_PURPOSE &&
+                    LINK_HOST_GET(peer.rcnt, 4 + peerPin);
+    return isDriven ? LINK_HOST_GET(peer.rcnt, peerPin) : true;
+  }
+};
+
+extern LinkHostBus* linkHostBus;
+
+class LinkHostRegister16 {
+ public:
+  explicit LinkHostRegister16(u32 address) : address(address) {}
+
+  operator u16() const { return linkHostBus->_read16(address); }
+
+  LinkHostRegister16& operator=(u16 value) {
+    linkHostBus->_write16(address, value);
+    return *this;
+  }
+  LinkHostRegister16& operator|=(int value) {
+    return *this = (u16)(*this | value);
+  }
+  LinkHostRegister16& operator&=(int value) {
+    return *this = (u16)(*this & value);
+  }
+  LinkHostRegister16& operator^=(int value) {
+    return *this = (u16)(*this ^ value);
+  }
+
+ private:
+  u32 address;
+};
+
+class LinkHostRegister32 {
+ public:
+  explicit LinkHostRegister32(u32 address) : address(address) {}
+
+  operator u32() const { return linkHostBus->_read32(address); }
+
+  LinkHostRegister32& operator=(u32 value) {
+    linkHostBus->_write32(address, value);
+    return *this;
+  }
+
+ private:
+  u32 address;
+};
+
+struct LinkHostRegister16Array {
+  u32 address;
+
+  LinkHostRegister16 operator[](u32 index) const {
+    return LinkHostRegister16(address + index * 2);
+  }
+};
+
+struct LinkHostTimerRegisters {
+  LinkHostRegister16 start;
+  LinkHostRegister16 count;
+  LinkHostRegister16 cnt;
+};
+
+struct LinkHostTimerArray {
+  LinkHostTimerRegisters operator[](u32 index) const {
+    u32 address = LINK_HOST_REG_TM + index * 4;
+    return LinkHostTimerRegisters{LinkHostRegister16(address),
+                                  LinkHostRegister16(address),
+                                  LinkHostRegister16(address + 2)};
+  }
+};
+
+#endif  // LINK_HOST_BUS_H
@@ -0,0 +1,130 @@
+#include <tonc.h>
+#include "LinkHostTest.h"
+
+// ISR:
+// Checks that `LinkCable::ISR<instance>` handlers drive their own instance,
+// with the default config and with a custom one, without the global
+// `linkCable` pointer (this test doesn't define it) and without a context
+// handler that swaps it between consoles.
+
+#include "../../LinkCable.h"
+
+#define FRAMES 600
+#define WARMUP_FRAMES 30
+#define COOLDOWN_FRAMES 60
+#define BITS_CONSOLE_ID 12
+#define SEQUENCE_MASK ((1 << BITS_CONSOLE_ID) - 1)
+
+struct ReliableConfig : LinkCableDefaultConfig {
+  static constexpr u32 MAX_PLAYERS = 3;
+  static constexpr bool RELIABLE = true;
+};
+using ReliableLinkCable = LinkCableT<ReliableConfig>;
+
+LinkHostBus* linkHostBus = NULL;
+
+LinkCable linkCable0, linkCable1;
+ReliableLinkCable reliableLinkCable0, reliableLinkCable1, reliableLinkCable2;
+
+struct Stream {
+  u32 sent;
+  u32 received[LINK_HOST_MAX_CONSOLES];
+  u32 errors[LINK_HOST_MAX_CONSOLES];  // (wrong sender or sequence)
+};
+
+Stream streams[LINK_HOST_MAX_CONSOLES];
+
+template <typename C, C& instance>
+void activate() {
+  irq_init(NULL);
+  irq_add(II_VBLANK, C::template ISR<instance>::VBLANK);
+  irq_add(II_SERIAL, C::template ISR<instance>::SERIAL);
+  irq_add(II_TIMER3, C::template ISR<instance>::TIMER);
+  instance.activate();
+}
+
+template <typename C>
+void exchange(C* linkCable, u32 id, u32 players, bool isSending) {
+  Stream& stream = streams[id];
+
+  // (the sequence starts at 1, since the default config can't send 0x0)
+  if (isSending &&
+      linkCable->send(((id + 1) << BITS_CONSOLE_ID) | (stream.sent + 1)))
+    stream.sent++;
+
+  for (u32 playerId = 0; playerId < players; playerId++) {
+    while (linkCable->canRead(playerId)) {
+      u16 word = linkCable->read(playerId);
+      u32 senderId = (word >> BITS_CONSOLE_ID) - 1;
+      u32 sequence = word & SEQUENCE_MASK;
+
+      if (senderId != playerId || sequence != stream.received[senderId] + 1)
+        stream.errors[playerId]++;
+      else
+        stream.received[senderId]++;
+    }
+  }
+
+  linkCable->consume();
+}
+
+template <typename C>
+void run(const char* name, C** linkCables, u32 players) {
+  for (u32 i = 0; i < players; i++)
+    streams[i] = Stream{};
+
+  for (u32 frame = 0; frame < FRAMES; frame++) {
+    bool isSending =
+        frame >= WARMUP_FRAMES && frame < FRAMES - COOLDOWN_FRAMES;
+    linkHostBus->runFrames(1, [linkCables, players, isSending](u32 id) {
+      exchange(linkCables[id], id, players, isSending);
+    });
+  }
+
+  printf("  %s, %d players: %d words sent by #0\n", name, players,
+         streams[0].sent);
+
+  for (u32 id = 0; id < players; id++) {
+    LINK_HOST_CHECK(linkCables[id]->isConnected() &&
+                        linkCables[id]->currentPlayerId() == id,
+                    "#%d is not connected as player %d", id, id);
+    LINK_HOST_CHECK(streams[id].sent > 0, "#%d didn't send anything", id);
+
+    for (u32 senderId = 0; senderId < players; senderId++) {
+      if (senderId == id)
+        continue;
+      Stream& stream = streams[id];
+      u32 sent = streams[senderId].sent;
+
+      LINK_HOST_CHECK(
+          stream.received[senderId] == sent && stream.errors[senderId] == 0,
+          "#%d got %d of %d words from #%d (%d errors)", id,
+          stream.received[senderId], sent, senderId, stream.errors[senderId]);
+    }
+  }
+
+  for (u32 i = 0; i < players; i++)
+    linkHostBus->runOn(i, [linkCables, i]() { linkCables[i]->deactivate(); });
+}
+
+int main() {
+  printf("LinkCable_isr\n");
+
+  linkHostBus = new LinkHostBus(2);
+  linkHostBus->runOn(0, activate<LinkCable, linkCable0>);
+  linkHostBus->runOn(1, activate<LinkCable, linkCable1>);
+  LinkCable* linkCables[] = {&linkCable0, &linkCable1};
+  run("default config", linkCables, 2);
+  delete linkHostBus;
+
+  linkHostBus = new LinkHostBus(3);
+  linkHostBus->runOn(0, activate<ReliableLinkCable, reliableLinkCable0>);
+  linkHostBus->runOn(1, activate<ReliableLinkCable, reliableLinkCable1>);
+  linkHostBus->runOn(2, activate<ReliableLinkCable, reliableLinkCable2>);
+  ReliableLinkCable* reliableLinkCables[] = {
+      &reliableLinkCable0, &reliableLinkCable1, &reliableLinkCable2};
+  run("custom config (RELIABLE)", reliableLinkCables, 3);
+  delete linkHostBus;
+
+  return LinkHostTest::result();
+}
@@ -0,0 +1,173 @@
+#include <tonc.h>
+#include "LinkHostTest.h"
+
+// RELIABLE:
+// Checks that LinkCable's RELIABLE mode delivers every word once and in order
+// when serial interrupts get lost (so the senders have to retransmit), and
+// when a player disconnects and the ones after it get renumbered.
+// Words are tagged with the id of the console that sent them, since player
+// ids change after a renumbering.
+
+// (the Makefile defines LINK_CABLE_ENABLE_STATS=1)
+#include "../../LinkCable.h"
+
+#define FRAMES 2400
+#define WARMUP_FRAMES 30
+#define COOLDOWN_FRAMES 300
+#define WORDS_PER_FRAME 8
+#define BITS_CONSOLE_ID 14
+#define SEQUENCE_MASK ((1 << BITS_CONSOLE_ID) - 1)
+#define DISCONNECT_PERIOD 300
+#define DISCONNECT_FRAMES 30
+
+struct ReliableConfig : LinkCableDefaultConfig {
+  static constexpr bool RELIABLE = true;
+};
+using ReliableLinkCable = LinkCableT<ReliableConfig>;
+
+struct Stream {
+  u32 sent;
+  u32 expected[LINK_HOST_MAX_CONSOLES];  // (next sequence, per sender)
+  u32 received[LINK_HOST_MAX_CONSOLES];
+  u32 duplicates[LINK_HOST_MAX_CONSOLES];  // (or out of order)
+  u32 gaps[LINK_HOST_MAX_CONSOLES];
+};
+
+LinkHostBus* linkHostBus = NULL;
+LinkCable* linkCable = NULL;
+ReliableLinkCable* linkCables[LINK_HOST_MAX_CONSOLES];
+ReliableLinkCable* currentLinkCable = NULL;
+Stream streams[LINK_HOST_MAX_CONSOLES];
+u32 dropRate = 0;  // (lost serial interrupts, per 1000)
+
+void receive(u32 id, u16 word) {
+  Stream& stream = streams[id];
+  u32 senderId = word >> BITS_CONSOLE_ID;
+  u32 sequence = word & SEQUENCE_MASK;
+  u32 expected = stream.expected[senderId] & SEQUENCE_MASK;
+
+  if (sequence == expected)
+    stream.received[senderId]++;
+  else if (((sequence - expected) & SEQUENCE_MASK) > SEQUENCE_MASK / 2)
+    stream.duplicates[senderId]++;
+  else {
+    stream.gaps[senderId]++;
+    stream.received[senderId]++;
+  }
+
+  stream.expected[senderId] += ((sequence - expected) & SEQUENCE_MASK) + 1;
+}
+
+void run(u32 players, u32 dropsPer1000, int disconnectedId) {
+  linkHostBus = new LinkHostBus(players);
+  dropRate = dropsPer1000;
+  for (u32 i = 0; i < players; i++) {
+    linkCables[i] = new ReliableLinkCable(ReliableLinkCable::BAUD_RATE_3,
+                                          LINK_CABLE_DEFAULT_TIMEOUT,
+                                          LINK_CABLE_DEFAULT_REMOTE_TIMEOUT, 10);
+    streams[i] = Stream{};
+  }
+  linkHostBus->setContextHandler(
+      [](u32 id) { currentLinkCable = linkCables[id]; });
+
+  for (u32 i = 0; i < players; i++) {
+    linkHostBus->runOn(i, []() {
+      irq_init(NULL);
+      irq_add(II_VBLANK, []() { currentLinkCable->_onVBlank(); });
+      irq_add(II_SERIAL, []() {
+        if (LinkHostTest::chance(dropRate, 1000))
+          return;  // (lost interrupt)
+        currentLinkCable->_onSerial();
+      });
+      irq_add(II_TIMER3, []() { currentLinkCable->_onTimer(); });
+      currentLinkCable->activate();
+    });
+  }
+
+  for (u32 frame = 0; frame < FRAMES; frame++) {
+    if (disconnectedId >= 0) {
+      u32 phase = frame % DISCONNECT_PERIOD;
+      if (phase == DISCONNECT_PERIOD / 3)
+        linkHostBus->setConnected(disconnectedId, false);
+      else if (phase == DISCONNECT_PERIOD / 3 + DISCONNECT_FRAMES)
+        linkHostBus->setConnected(disconnectedId, true);
+    }
+
+    bool isSending =
+        frame >= WARMUP_FRAMES && frame < FRAMES - COOLDOWN_FRAMES;
+    linkHostBus->runFrames(1, [isSending, players](u32 id) {
+      Stream& stream = streams[id];
+      if (isSending) {
+        u16 words[WORDS_PER_FRAME];
+        for (u32 i = 0; i < WORDS_PER_FRAME; i++)
+          words[i] = (id << BITS_CONSOLE_ID) |
+                     ((stream.sent + i) & SEQUENCE_MASK);
+        stream.sent += currentLinkCable->send(words, WORDS_PER_FRAME);
+      }
+
+      // (words received before a renumbering stay in the queue of the id
+      //  that their sender had, even if that's our id now)
+      for (u32 playerId = 0; playerId < players; playerId++) {
+        u16 words[64];
+        u32 count = currentLinkCable->readAll(playerId, words, 64);
+        for (u32 i = 0; i < count; i++)
+          receive(id, words[i]);
+      }
+
+      currentLinkCable->consume();
+    });
+  }
+
+  u32 retransmitted = 0;
+  for (u32 i = 0; i < players; i++)
+    retransmitted += linkCables[i]->getStats().retransmittedMessages;
+
+  printf("  %d players, %d/1000 lost IRQs", players, dropsPer1000);
+  if (disconnectedId >= 0)
+    printf(", disconnecting #%d", disconnectedId);
+  printf(": %d retransmitted\n", retransmitted);
+
+  for (u32 id = 0; id < players; id++) {
+    for (u32 senderId = 0; senderId < players; senderId++) {
+      if (senderId == id)
+        continue;
+      Stream& stream = streams[id];
+      u32 sent = streams[senderId].sent;
+      bool canLose = (int)id == disconnectedId || (int)senderId == disconnectedId;
+
+      LINK_HOST_CHECK(stream.duplicates[senderId] == 0,
+                      "#%d got %d duplicated words from #%d", id,
+                      stream.duplicates[senderId], senderId);
+      if (!canLose) {
+        LINK_HOST_CHECK(stream.received[senderId] == sent &&
+                            stream.gaps[senderId] == 0,
+                        "#%d got %d of %d words from #%d (%d gaps)", id,
+                        stream.received[senderId], sent, senderId,
+                        stream.gaps[senderId]);
+      }
+    }
+  }
+  if (dropsPer1000 > 0)
+    LINK_HOST_CHECK(retransmitted > 0, "nothing was retransmitted");
+
+  for (u32 i = 0; i < players; i++)
+    delete linkCables[i];
+  delete linkHostBus;
+}
+
+int main() {
+  printf("LinkCable_reliable\n");
+
+  for (u32 players = 2; players <= 4; players++)
+    run(players, 10, -1);
+
+  // (the last player doesn't renumber anyone, the second one and the master
+  //  do, and reconnecting renumbers them back)
+  run(3, 0, 2);
+  run(3, 0, 1);
+  run(4, 0, 1);
+  run(4, 5, 1);
+  run(4, 5, 0);
+
+  return LinkHostTest::result();
+}
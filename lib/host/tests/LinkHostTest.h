@@ -0,0 +1,50 @@
+#ifndef LINK_HOST_TEST_H
+#define LINK_HOST_TEST_H
+
+// --------------------------------------------------------------------------
+// Helpers for the host tests in this folder (see Makefile).
+// --------------------------------------------------------------------------
+// Usage:
+// - 1) Check conditions with printf-style messages:
+//       LINK_HOST_CHECK(received == sent, "received %d of %d", received, sent);
+// - 2) Use a deterministic random source (e.g. to drop interrupts), so every
+//      run produces the same results:
+//       if (LinkHostTest::chance(1, 100)) return;  // (1% of the time)
+// - 3) Return the result from `main()`:
+//       return LinkHostTest::result();
+// --------------------------------------------------------------------------
+
+#include <cstdio>
+
+#define LINK_HOST_CHECK(CONDITION, ...)                      \
+  do {                                                       \
+    if (!(CONDITION)) {                                      \
+      printf("  FAILED (%s:%d): ", __FILE__, __LINE__);      \
+      printf(__VA_ARGS__);                                   \
+      printf("\n");                                          \
+      LinkHostTest::failures++;                              \
+    }                                                        \
+  } while (0)
+
+namespace LinkHostTest {
+
+inline u32 failures = 0;
+inline u32 seed = 1;
+
+inline u32 random() {
+  seed = seed * 1664525 + 1013904223;
+  return seed >> 8;
+}
+
+inline bool chance(u32 count, u32 total) {
+  return random() % total < count;
+}
+
+inline int result() {
+  printf(failures == 0 ? "OK\n" : "FAILED (%d checks)\n", failures);
+  return failures == 0 ? 0 : 1;
+}
+
+}  // namespace LinkHostTest
+
+#endif  // LINK_HOST_TEST_H
@@ -0,0 +1,71 @@
+#include <tonc.h>
+#include "LinkHostTest.h"
+
+// ISR:
+// Checks that `LinkSPI::ISR<instance>::SERIAL` completes the async transfers
+// of its own instance, without the global `linkSPI` pointer (this test
+// doesn't define it).
+
+#include "../../LinkSPI.h"
+
+#define TRANSFERS 100
+#define MASTER_BASE 0x10000
+#define SLAVE_BASE 0x20000
+
+LinkHostBus* linkHostBus = NULL;
+
+LinkSPI masterLinkSPI, slaveLinkSPI;
+LinkSPI* linkSPIs[] = {&masterLinkSPI, &slaveLinkSPI};
+const u32 BASES[] = {MASTER_BASE, SLAVE_BASE};
+u32 sent[2];
+u32 received[2];
+u32 errors[2];
+
+template <LinkSPI& instance, LinkSPI::Mode mode>
+void activate() {
+  irq_init(NULL);
+  irq_add(II_SERIAL, LinkSPI::ISR<instance>::SERIAL);
+  instance.activate(mode);
+}
+
+int main() {
+  printf("LinkSPI_isr\n");
+
+  linkHostBus = new LinkHostBus(2);
+  linkHostBus->runOn(1, activate<slaveLinkSPI, LinkSPI::Mode::SLAVE>);
+  linkHostBus->runOn(0, activate<masterLinkSPI, LinkSPI::Mode::MASTER_256KBPS>);
+
+  // (the slave goes first, so it's always waiting when the master starts)
+  for (u32 frame = 0; frame < TRANSFERS * 2; frame++) {
+    for (int id = 1; id >= 0; id--) {
+      linkHostBus->runOn(id, [id]() {
+        LinkSPI* linkSPI = linkSPIs[id];
+        u32 otherBase = BASES[1 - id];
+
+        if (linkSPI->getAsyncState() == LinkSPI::AsyncState::READY) {
+          u32 data = linkSPI->getAsyncData();
+          if (data == otherBase + received[id])
+            received[id]++;
+          else
+            errors[id]++;
+        }
+
+        if (linkSPI->getAsyncState() == LinkSPI::AsyncState::IDLE &&
+            sent[id] < TRANSFERS)
+          linkSPI->transferAsync(BASES[id] + sent[id]++);
+      });
+    }
+    linkHostBus->waitVBlank();
+  }
+
+  printf("  %d transfers\n", received[0]);
+
+  for (u32 id = 0; id < 2; id++)
+    LINK_HOST_CHECK(received[id] == TRANSFERS && errors[id] == 0,
+                    "#%d got %d of %d transfers (%d errors)", id,
+                    received[id], TRANSFERS, errors[id]);
+
+  delete linkHostBus;
+
+  return LinkHostTest::result();
+}
@@ -0,0 +1,545 @@
+#ifndef LINK_WIRELESS_FAKE_ADAPTER_H
+#define LINK_WIRELESS_FAKE_ADAPTER_H
+
+// --------------------------------------------------------------------------
+// Simulated Wireless Adapters, so LinkWireless runs its real protocol.
+// --------------------------------------------------------------------------
+// Normal mode connects consoles in pairs, so the even consoles are the GBAs
+// and the odd ones are their adapters (up to 2 GBAs). Each adapter runs on
+// its own serial and timer interrupts, and implements:
+// - the login, the commands and their ACKs (including the reversed ACK and
+//   the clock switch after SendDataWait/Wait, see docs/wireless_adapter.md)
+// - a simulated air, where hosts broadcast and accept clients, and each
+//   host's SendData reaches its clients and brings back their scheduled data
+// - a restart when its GBA switches to General Purpose mode (the SD ping)
+// Usage:
+// - 1) Define `LinkHostBus* linkHostBus = new LinkHostBus(4);`, and include
+//      LinkWireless.h and then this header
+// - 2) Start the adapters (before activating LinkWireless):
+//       LinkWirelessFakeAdapter::install(2);
+// - 3) Run the GBAs (the adapters don't need a game loop):
+//       linkHostBus->runFrames(1, [](u32 id) {
+//         if (id % 2 == 0) { /* ... */ }
+//       });
+// - 4) Tweak or inspect the adapter of a GBA:
+//       LinkWirelessFakeAdapter::of(2).lossRate = 100;  // (per 1000)
+//       u32 polls = LinkWirelessFakeAdapter::of(2).emptyReceives;
+// --------------------------------------------------------------------------
+
+#define LINK_WIRELESS_FAKE_ADAPTER_MAX_ADAPTERS (LINK_HOST_MAX_CONSOLES / 2)
+#define LINK_WIRELESS_FAKE_ADAPTER_MAX_WORDS 64
+#define LINK_WIRELESS_FAKE_ADAPTER_POLL_CYCLES 256
+#define LINK_WIRELESS_FAKE_ADAPTER_WAIT_TIMEOUT (LINK_HOST_CPU_FREQUENCY / 2)
+#define LINK_WIRELESS_FAKE_ADAPTER_BASE_ID 0x7a00
+#define LINK_WIRELESS_FAKE_ADAPTER_BROKEN_LOGIN 0x12345678
+#define LINK_WIRELESS_FAKE_ADAPTER_SIOCNT ((1 << 12) | (1 << 14))
+#define LINK_WIRELESS_FAKE_ADAPTER_BIT_CLOCK 0
+#define LINK_WIRELESS_FAKE_ADAPTER_BIT_CLOCK_SPEED 1
+#define LINK_WIRELESS_FAKE_ADAPTER_BIT_SI 2
+#define LINK_WIRELESS_FAKE_ADAPTER_BIT_SO 3
+#define LINK_WIRELESS_FAKE_ADAPTER_BIT_START 7
+
+class LinkWirelessFakeAdapter {
+ public:
+  u16 id;
+  bool isBroken = false;           // (it answers the login with garbage)
+  bool ignoresReverseAck = false;  // (it never goes high after a Wait)
+  u32 lossRate = 0;                // (per 1000 transmissions over the air)
+  u32 commands[256] = {};          // (how many times each one was received)
+  u32 emptyReceives = 0;           // (ReceiveData without new data)
+  u32 deliveries = 0;              // (host transfers read by a client)
+  u64 deliveryCycles = 0;          // (from the host's SendData to them)
+  u32 overwrites = 0;              // (host transfers that were never read)
+  u32 wakeUps = 0;                 // (0x28 events, after SendDataWait/Wait)
+  u32 waitTimeouts = 0;            // (0x27 events, after SendDataWait/Wait)
+  u32 restarts = 0;
+
+  static void install(u32 totalAdapters) {
+    for (u32 i = 0; i < LINK_WIRELESS_FAKE_ADAPTER_MAX_ADAPTERS; i++) {
+      delete adapters[i];
+      adapters[i] = NULL;
+    }
+
+    LinkWirelessFakeAdapter::totalAdapters = totalAdapters;
+    for (u32 i = 0; i < totalAdapters; i++) {
+      adapters[i] = new LinkWirelessFakeAdapter();
+      adapters[i]->index = i;
+      adapters[i]->id = LINK_WIRELESS_FAKE_ADAPTER_BASE_ID + i;
+    }
+
+    for (u32 i = 0; i < totalAdapters; i++) {
+      linkHostBus->setPeripheral(consoleOf(i), true);
+      linkHostBus->runOn(consoleOf(i), []() {
+        irq_init(NULL);
+        irq_add(II_SERIAL, onSerialIRQ);
+        irq_add(II_TIMER0, onTimerIRQ);
+        REG_RCNT = 0;
+        current().restart();
+        REG_TM[0].start = -LINK_WIRELESS_FAKE_ADAPTER_POLL_CYCLES;
+        REG_TM[0].cnt = TM_ENABLE | TM_IRQ;
+      });
+    }
+  }
+
+  static LinkWirelessFakeAdapter& of(u32 gbaId) { return *adapters[gbaId / 2]; }
+
+  bool isConnectedTo(LinkWirelessFakeAdapter& host) {
+    return hostIndex == (int)host.index;
+  }
+
+ private:
+  enum Step { LOGIN, COMMAND, PARAMETERS, RESPONSES };
+  enum Phase {
+    IDLE,
+    ACK_LOW,       // (the GBA goes low, the adapter goes high)
+    ACK_HIGH,      // (the GBA goes high, the adapter goes low when ready)
+    REVERSE_HIGH,  // (after a Wait: the GBA goes high, the adapter too)
+    WAIT_EVENT,    // (the adapter sends an event when the GBA is low)
+    ACK_REQUEST,   // (the adapter asks for the event's ACK)
+    RESUME,        // (the clock control returns to the GBA)
+    TRANSFERRING
+  };
+
+  static inline LinkWirelessFakeAdapter*
+      adapters[LINK_WIRELESS_FAKE_ADAPTER_MAX_ADAPTERS] = {};
+  static inline u32 totalAdapters = 0;
+
+  u32 index = 0;
+  Step step = LOGIN;
+  Phase phase = IDLE;
+  u32 loginPackets = 0;
+  u16 previousGBAData = 0xffff;
+  bool isPinged = false;
+
+  u8 commandType = 0;
+  u32 totalParameters = 0;
+  u32 parametersSize = 0;
+  u32 parameters[LINK_WIRELESS_FAKE_ADAPTER_MAX_WORDS];
+  u32 responses[LINK_WIRELESS_FAKE_ADAPTER_MAX_WORDS];
+  u32 responsesSize = 0;
+  u32 sentResponses = 0;
+  u32 nextData = LINK_WIRELESS_DATA_REQUEST;
+  bool willWait = false;
+  bool isLastResponseArmed = false;
+  bool isAckBeforeWait = false;
+
+  u32 reverseAcks = 0;
+  u64 waitStart = 0;
+  u32 event = 0;
+
+  // (air)
+  bool isHosting = false;
+  u32 broadcast[LINK_WIRELESS_BROADCAST_LENGTH] = {};
+  int hostIndex = -1;
+  bool isConnecting = false;
+  int connectingTo = -1;
+  u32 slot = 0;
+  u32 clients = 0;
+  u32 incoming[LINK_WIRELESS_FAKE_ADAPTER_MAX_WORDS];
+  u32 incomingSize = 0;
+  u64 incomingAt = 0;
+  u32 scheduled[LINK_WIRELESS_FAKE_ADAPTER_MAX_WORDS];
+  u32 scheduledSize = 0;
+  u32 clientData[LINK_WIRELESS_MAX_PLAYERS]
+                [LINK_WIRELESS_FAKE_ADAPTER_MAX_WORDS];
+  u32 clientDataSize[LINK_WIRELESS_MAX_PLAYERS] = {};
+
+  static u32 consoleOf(u32 index) { return index * 2 + 1; }
+  static u32 gbaOf(u32 index) { return index * 2; }
+  static LinkWirelessFakeAdapter& current() {
+    return *adapters[linkHostBus->currentConsole() / 2];
+  }
+
+  static void onSerialIRQ() { current().onSerial(); }
+  static void onTimerIRQ() { current().onTimer(); }
+
+  void restart() {
+    disconnect();
+
+    step = LOGIN;
+    phase = IDLE;
+    loginPackets = 0;
+    previousGBAData = 0xffff;
+    isHosting = false;
+    isConnecting = false;
+    incomingSize = 0;
+    scheduledSize = 0;
+    willWait = false;
+    isLastResponseArmed = false;
+    isAckBeforeWait = false;
+    restarts++;
+
+    becomeSlave();
+    setSO(false);
+    arm(loginResponse());
+  }
+
+  void disconnect() {
+    for (u32 i = 0; i < totalAdapters; i++) {
+      LinkWirelessFakeAdapter& other = *adapters[i];
+      if (other.hostIndex == (int)index || other.connectingTo == (int)index) {
+        other.hostIndex = -1;
+        other.connectingTo = -1;
+      }
+    }
+
+    hostIndex = -1;
+    connectingTo = -1;
+    clients = 0;
+    for (u32 i = 0; i < LINK_WIRELESS_MAX_PLAYERS; i++)
+      clientDataSize[i] = 0;
+  }
+
+  void onSerial() {
+    u32 data = REG_SIODATA32;
+
+    if (step == LOGIN) {
+      // (login packets don't use the ACK)
+      previousGBAData = data & 0xffff;
+      loginPackets++;
+      if (loginPackets > LINK_WIRELESS_LOGIN_STEPS)
+        step = COMMAND;
+      arm(step == LOGIN ? loginResponse() : LINK_WIRELESS_DATA_REQUEST);
+      return;
+    }
+
+    if (isMaster()) {
+      // (a transfer during a Wait: the event, or the GBA's ACK of it)
+      reverseAcks++;
+      phase = REVERSE_HIGH;
+      return;
+    }
+
+    if (isLastResponseArmed) {
+      // (the last response of SendDataWait/Wait was sent, so after its ACK,
+      //  the adapter takes control of the clock)
+      isLastResponseArmed = false;
+      isAckBeforeWait = true;
+      phase = ACK_LOW;
+      return;
+    }
+
+    receive(data);
+    phase = ACK_LOW;
+  }
+
+  void onTimer() {
+    bool isGBAPinging = linkHostBus->getMode(gbaOf(index)) ==
+                        LinkHostBus::Mode::GENERAL_PURPOSE;
+    if (isGBAPinging && !isPinged)
+      restart();
+    isPinged = isGBAPinging;
+    if (isGBAPinging)
+      return;
+
+    bool isGBAHigh = (REG_SIOCNT >> LINK_WIRELESS_FAKE_ADAPTER_BIT_SI) & 1;
+
+    switch (phase) {
+      case ACK_LOW: {
+        if (!isGBAHigh) {
+          setSO(true);
+          phase = ACK_HIGH;
+        }
+        break;
+      }
+      case ACK_HIGH: {
+        if (!isGBAHigh)
+          break;
+
+        setSO(false);
+        if (isAckBeforeWait) {
+          isAckBeforeWait = false;
+          becomeMaster();
+          reverseAcks = 0;
+          phase = REVERSE_HIGH;
+        } else {
+          arm(nextData);
+          phase = IDLE;
+        }
+        break;
+      }
+      case REVERSE_HIGH: {
+        if (!isGBAHigh || ignoresReverseAck)
+          break;
+
+        setSO(true);
+        if (reverseAcks == 0) {
+          waitStart = linkHostBus->getCycles();
+          phase = WAIT_EVENT;
+        } else {
+          phase = reverseAcks == 1 ? ACK_REQUEST : RESUME;
+        }
+        break;
+      }
+      case WAIT_EVENT: {
+        bool hasTimedOut = linkHostBus->getCycles() - waitStart >
+                           LINK_WIRELESS_FAKE_ADAPTER_WAIT_TIMEOUT;
+        if (incomingSize == 0 && !hasTimedOut)
+          break;
+        if (isGBAHigh)
+          break;
+
+        event = incomingSize > 0 ? LINK_WIRELESS_EVENT_DATA_AVAILABLE
+                                 : LINK_WIRELESS_EVENT_WAIT_TIMEOUT;
+        if (event == LINK_WIRELESS_EVENT_DATA_AVAILABLE)
+          wakeUps++;
+        else
+          waitTimeouts++;
+
+        setSO(false);
+        phase = TRANSFERRING;
+        arm(buildCommand(event, 0));
+        break;
+      }
+      case ACK_REQUEST: {
+        if (isGBAHigh)
+          break;
+
+        setSO(false);
+        phase = TRANSFERRING;
+        arm(LINK_WIRELESS_DATA_REQUEST);
+        break;
+      }
+      case RESUME: {
+        becomeSlave();
+        setSO(false);
+        step = COMMAND;
+        phase = IDLE;
+        arm(LINK_WIRELESS_DATA_REQUEST);
+        break;
+      }
+      default: {
+      }
+    }
+  }
+
+  void receive(u32 data) {
+    switch (step) {
+      case COMMAND: {
+        if ((data >> 16) != LINK_WIRELESS_COMMAND_HEADER)
+          break;
+
+        commandType = data & 0xff;
+        totalParameters = (data >> 8) & 0xff;
+        parametersSize = 0;
+        commands[commandType]++;
+        if (totalParameters == 0)
+          runCommand();
+        else
+          step = PARAMETERS;
+        break;
+      }
+      case PARAMETERS: {
+        if (parametersSize < LINK_WIRELESS_FAKE_ADAPTER_MAX_WORDS)
+          parameters[parametersSize] = data;
+        parametersSize++;
+        if (parametersSize == totalParameters)
+          runCommand();
+        break;
+      }
+      default: {
+      }
+    }
+
+    nextData = LINK_WIRELESS_DATA_REQUEST;
+    if (step == RESPONSES) {
+      nextData = sentResponses == 0
+                     ? buildCommand(commandType + LINK_WIRELESS_RESPONSE_ACK,
+                                    responsesSize)
+                     : responses[sentResponses - 1];
+      sentResponses++;
+
+      if (sentResponses > responsesSize) {
+        step = COMMAND;
+        isLastResponseArmed = willWait;
+        willWait = false;
+      }
+    }
+  }
+
+  void runCommand() {
+    u32 size =
+        std::min(parametersSize, (u32)LINK_WIRELESS_FAKE_ADAPTER_MAX_WORDS);
+    responsesSize = 0;
+    sentResponses = 0;
+    step = RESPONSES;
+
+    switch (commandType) {
+      case LINK_WIRELESS_COMMAND_BROADCAST: {
+        for (u32 i = 0; i < size && i < LINK_WIRELESS_BROADCAST_LENGTH; i++)
+          broadcast[i] = parameters[i];
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_START_HOST: {
+        disconnect();
+        isHosting = true;
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_ACCEPT_CONNECTIONS: {
+        for (u32 i = 0; i < totalAdapters; i++) {
+          LinkWirelessFakeAdapter& other = *adapters[i];
+          if (other.isConnectedTo(*this))
+            responses[responsesSize++] = (other.slot << 16) | other.id;
+        }
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_BROADCAST_READ_POLL: {
+        for (u32 i = 0; i < totalAdapters; i++) {
+          LinkWirelessFakeAdapter& other = *adapters[i];
+          if (i == index || !other.isHosting)
+            continue;
+
+          responses[responsesSize++] = other.id;
+          for (u32 j = 0; j < LINK_WIRELESS_BROADCAST_LENGTH; j++)
+            responses[responsesSize++] = other.broadcast[j];
+        }
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_CONNECT: {
+        disconnect();
+        for (u32 i = 0; i < totalAdapters; i++) {
+          if (size > 0 && adapters[i]->id == (u16)parameters[0] &&
+              adapters[i]->isHosting)
+            connectingTo = i;
+        }
+        isConnecting = false;
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_IS_FINISHED_CONNECT: {
+        // (the first poll is always "still connecting")
+        if (connectingTo == -1 || !isConnecting) {
+          isConnecting = connectingTo != -1;
+          responses[responsesSize++] = LINK_WIRELESS_STILL_CONNECTING;
+          break;
+        }
+
+        LinkWirelessFakeAdapter& host = *adapters[connectingTo];
+        slot = host.clients++;
+        hostIndex = connectingTo;
+        connectingTo = -1;
+        responses[responsesSize++] = (slot << 16) | id;
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_SEND_DATA:
+      case LINK_WIRELESS_COMMAND_SEND_DATA_WAIT: {
+        if (isHosting)
+          transmit(size);
+        else {
+          for (u32 i = 0; i < size; i++)
+            scheduled[i] = parameters[i];
+          scheduledSize = size;
+        }
+
+        willWait = commandType == LINK_WIRELESS_COMMAND_SEND_DATA_WAIT;
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_RECEIVE_DATA: {
+        if (isHosting)
+          receiveFromClients();
+        else if (incomingSize > 0) {
+          for (u32 i = 0; i < incomingSize; i++)
+            responses[responsesSize++] = incoming[i];
+          incomingSize = 0;
+          deliveries++;
+          deliveryCycles += linkHostBus->getCycles() - incomingAt;
+        }
+
+        if (responsesSize == 0)
+          emptyReceives++;
+        break;
+      }
+      case LINK_WIRELESS_COMMAND_WAIT: {
+        willWait = true;
+        break;
+      }
+      default: {
+      }
+    }
+  }
+
+  void transmit(u32 size) {
+    // (each client gets the host's data and sends back its scheduled data)
+    for (u32 i = 0; i < totalAdapters; i++) {
+      LinkWirelessFakeAdapter& client = *adapters[i];
+      if (!client.isConnectedTo(*this))
+        continue;
+
+      if (!LinkHostTest::chance(lossRate, 1000)) {
+        if (client.incomingSize > 0)
+          client.overwrites++;
+        for (u32 j = 0; j < size; j++)
+          client.incoming[j] = parameters[j];
+        client.incomingSize = size;
+        client.incomingAt = linkHostBus->getCycles();
+      }
+
+      if (client.scheduledSize > 0 && !LinkHostTest::chance(lossRate, 1000)) {
+        for (u32 j = 0; j < client.scheduledSize; j++)
+          clientData[client.slot][j] = client.scheduled[j];
+        clientDataSize[client.slot] = client.scheduledSize;
+      }
+      client.scheduledSize = 0;
+    }
+  }
+
+  void receiveFromClients() {
+    // (one header with the byte count of each client, then their data)
+    responses[responsesSize++] = 0;
+    for (u32 i = 0; i < LINK_WIRELESS_MAX_PLAYERS; i++) {
+      if (clientDataSize[i] == 0)
+        continue;
+
+      responses[0] |= clientData[i][0];
+      for (u32 j = 1; j < clientDataSize[i]; j++)
+        responses[responsesSize++] = clientData[i][j];
+      clientDataSize[i] = 0;
+    }
+
+    if (responsesSize == 1)
+      responsesSize = 0;
+  }
+
+  u32 loginResponse() {
+    if (isBroken)
+      return LINK_WIRELESS_FAKE_ADAPTER_BROKEN_LOGIN;
+
+    u16 expected =
+        loginPackets == 0 ? 0 : LINK_WIRELESS_LOGIN_PARTS[loginPackets - 1];
+    return ((u32)expected << 16) | (u16)~previousGBAData;
+  }
+
+  u32 buildCommand(u8 type, u32 length) {
+    return (LINK_WIRELESS_COMMAND_HEADER << 16) | (length << 8) | type;
+  }
+
+  bool isMaster() {
+    return (REG_SIOCNT >> LINK_WIRELESS_FAKE_ADAPTER_BIT_CLOCK) & 1;
+  }
+
+  void becomeMaster() {
+    REG_SIOCNT = LINK_WIRELESS_FAKE_ADAPTER_SIOCNT |
+                 (1 << LINK_WIRELESS_FAKE_ADAPTER_BIT_CLOCK) |
+                 (1 << LINK_WIRELESS_FAKE_ADAPTER_BIT_CLOCK_SPEED) |
+                 (REG_SIOCNT & (1 << LINK_WIRELESS_FAKE_ADAPTER_BIT_SO));
+  }
+
+  void becomeSlave() {
+    REG_SIOCNT = LINK_WIRELESS_FAKE_ADAPTER_SIOCNT |
+                 (REG_SIOCNT & (1 << LINK_WIRELESS_FAKE_ADAPTER_BIT_SO));
+  }
+
+  void setSO(bool isHigh) {
+    if (isHigh)
+      REG_SIOCNT = REG_SIOCNT | (1 << LINK_WIRELESS_FAKE_ADAPTER_BIT_SO);
+    else
+      REG_SIOCNT = REG_SIOCNT & ~(1 << LINK_WIRELESS_FAKE_ADAPTER_BIT_SO);
+  }
+
+  void arm(u32 data) {
+    // (as a slave, it waits for the GBA's clock; as a master, it starts)
+    REG_SIODATA32 = data;
+    REG_SIOCNT = REG_SIOCNT | (1 << LINK_WIRELESS_FAKE_ADAPTER_BIT_START);
+  }
+};
+
+#endif  // LINK_WIRELESS_FAKE_ADAPTER_H
@@ -0,0 +1,166 @@
+#ifndef LINK_WIRELESS_LOOPBACK_H
+#define LINK_WIRELESS_LOOPBACK_H
+
+// --------------------------------------------------------------------------
+// Connects LinkWireless nodes to each other, without Wireless Adapters.
+// --------------------------------------------------------------------------
+// It skips the adapter commands and moves the transfers that each node would
+// send with SendData to the nodes that would get them with ReceiveData, so
+// tests can check the session protocol (retransmission, forwarding, buffers,
+// transfer CRCs...) under loss, reordering and corruption.
+// Usage:
+// - 1) Define `LinkHostBus* linkHostBus = new LinkHostBus(1);` and the
+//      LINK_WIRELESS_* options, and include this header
+// - 2) Create a session (node 0 is the server):
+//       LinkWirelessLoopback loopback(3, forwarding, retransmission);
+//       loopback.lossRate = 200;  // (per 1000 transfers)
+// - 3) Send messages with `loopback.nodes[id]->send(...)`, call `tick()` to
+//      run one server transfer and one transfer per client, and read them:
+//       LinkWireless::Message messages[LINK_WIRELESS_LOOPBACK_MAX_MESSAGES];
+//       u32 count = loopback.receive(id, messages);
+// --------------------------------------------------------------------------
+
+// (LinkWireless declares this struct as a friend, so it can reach the
+//  session internals; tests only use its public interface)
+#include <tonc.h>
+#include "LinkHostTest.h"
+
+#include "../../LinkWireless.h"
+
+#define LINK_WIRELESS_LOOPBACK_MAX_MESSAGES (LINK_WIRELESS_QUEUE_SIZE + 1)
+#define LINK_WIRELESS_LOOPBACK_WARMUP_TICKS 4
+
+struct LinkWirelessLoopback {
+  using CommandResult = LinkWireless::CommandResult;
+
+  LinkWireless* nodes[LINK_WIRELESS_MAX_PLAYERS];
+  u32 playerCount;
+  u32 lossRate = 0;        // (per 1000 transfers)
+  u32 reorderRate = 0;     // (per 1000 transfers, delivered after the next)
+  u32 corruptionRate = 0;  // (per 1000 words)
+  u32 corruptedBits = 1;   // (flipped bits per corrupted word)
+  u32 transfers = 0;
+
+  LinkWirelessLoopback(u32 playerCount, bool forwarding, bool retransmission)
+      : playerCount(playerCount) {
+    for (u32 i = 0; i < playerCount; i++) {
+      LinkWireless* node =
+          new LinkWireless(forwarding, retransmission, playerCount);
+      node->resetState();
+      node->copyState();
+      node->isEnabled = true;
+      node->state = i == 0 ? LinkWireless::SERVING : LinkWireless::CONNECTED;
+      node->sessionState.playerCount = playerCount;
+      node->sessionState.currentPlayerId = i;
+      nodes[i] = node;
+      delayed[i] = CommandResult{};
+    }
+
+    // (like after connecting, the clients learn the server's packet ids from
+    //  its confirmations before any message is sent)
+    for (u32 i = 0; i < LINK_WIRELESS_LOOPBACK_WARMUP_TICKS; i++)
+      tick();
+    transfers = 0;
+  }
+
+  ~LinkWirelessLoopback() {
+    for (u32 i = 0; i < playerCount; i++)
+      delete nodes[i];
+  }
+
+  void tick() {
+    CommandResult serverTransfer = build(0);
+    for (u32 i = 1; i < playerCount; i++)
+      deliver(i, serverTransfer);
+
+    // (the server gets all client transfers in one ReceiveData response,
+    //  whose first word has the byte count of each client)
+    CommandResult clientTransfers;
+    clientTransfers.success = true;
+    clientTransfers.responses[0] = 0;
+    clientTransfers.responsesSize = 1;
+    for (u32 i = 1; i < playerCount; i++) {
+      CommandResult transfer = build(i);
+      if (LinkHostTest::chance(lossRate, 1000))
+        continue;
+
+      clientTransfers.responses[0] |= transfer.responses[0];
+      for (u32 j = 1; j < transfer.responsesSize; j++)
+        clientTransfers.responses[clientTransfers.responsesSize++] =
+            transfer.responses[j];
+    }
+    deliver(0, clientTransfers, false);
+
+    transfers++;
+  }
+
+  u32 receive(u32 id, LinkWireless::Message* messages) {
+    for (u32 i = 0; i < LINK_WIRELESS_LOOPBACK_MAX_MESSAGES; i++)
+      messages[i] = LinkWireless::Message{};
+    nodes[id]->receive(messages);
+
+    u32 count = 0;
+    while (count < LINK_WIRELESS_LOOPBACK_MAX_MESSAGES &&
+           messages[count].packetId != LINK_WIRELESS_END)
+      count++;
+    return count;
+  }
+
+  // (the transfer that node `id` would send now, with its wireless header)
+  CommandResult build(u32 id) {
+    LinkWireless& node = *nodes[id];
+    node.copyState();
+    int lastPacketId = node.setDataFromOutgoingMessages();
+    node.clearOutgoingMessagesIfNeeded(lastPacketId);
+
+    CommandResult result;
+    result.success = true;
+    result.responsesSize = node.nextCommandDataSize;
+    for (u32 i = 0; i < result.responsesSize; i++)
+      result.responses[i] = node.nextCommandData[i];
+    return result;
+  }
+
+  // (hands a ReceiveData response to node `id`, and publishes its messages)
+  void receiveTransfer(u32 id, CommandResult& result) {
+    nodes[id]->addIncomingMessagesFromData(result);
+    nodes[id]->copyState();
+  }
+
+ private:
+  CommandResult delayed[LINK_WIRELESS_MAX_PLAYERS];
+
+  void deliver(u32 id, CommandResult result, bool canLose = true) {
+    // (a delayed transfer arrives right after the next one, even if that one
+    //  is lost, so transfers are never more than one transfer late)
+    if (canLose && LinkHostTest::chance(lossRate, 1000)) {
+      if (delayed[id].success) {
+        receiveTransfer(id, delayed[id]);
+        delayed[id] = CommandResult{};
+      }
+      return;
+    }
+
+    for (u32 i = 1; i < result.responsesSize; i++) {
+      if (!LinkHostTest::chance(corruptionRate, 1000))
+        continue;
+
+      u32 original = result.responses[i];
+      while ((u32)__builtin_popcount(result.responses[i] ^ original) <
+             corruptedBits)
+        result.responses[i] ^= 1 << (LinkHostTest::random() % 32);
+    }
+
+    if (delayed[id].success) {
+      receiveTransfer(id, result);
+      receiveTransfer(id, delayed[id]);
+      delayed[id] = CommandResult{};
+    } else if (LinkHostTest::chance(reorderRate, 1000)) {
+      delayed[id] = result;
+    } else {
+      receiveTransfer(id, result);
+    }
+  }
+};
+
+#endif  // LINK_WIRELESS_LOOPBACK_H
@@ -0,0 +1,176 @@
+#ifndef LINK_WIRELESS_SESSION_H
+#define LINK_WIRELESS_SESSION_H
+
+// --------------------------------------------------------------------------
+// A message stream scenario for LinkWirelessLoopback sessions.
+// --------------------------------------------------------------------------
+// Every sender sends a numbered sequence of messages, every node reads its
+// queue, and the results say how many messages arrived from each sender,
+// how many were wrong (duplicated, out of order or corrupted), and how many
+// transfers they took. The tests of each LINK_WIRELESS_USE_* option include
+// it with their own options defined, so the same scenarios are measured in
+// each wire format.
+// Usage:
+// - 1) Define the LINK_WIRELESS_* options, include this header and define
+//      `LinkHostBus* linkHostBus = new LinkHostBus(1);`
+// - 2) Run a scenario:
+//       LinkWirelessSession::Scenario scenario;
+//       scenario.players = 3;
+//       scenario.lossRate = 200;  // (per 1000 transfers)
+//       LinkWirelessSession::Result result = LinkWirelessSession::run(scenario);
+// - 3) Check that every stream arrived complete, in order, and without
+//      stalling (see `minThroughput` and `maxLatency`):
+//       LinkWirelessSession::check(scenario, result);
+// --------------------------------------------------------------------------
+
+#include <algorithm>
+#include "LinkWirelessLoopback.h"
+
+#define LINK_WIRELESS_SESSION_SEQUENCE_MASK 0x7fff
+#define LINK_WIRELESS_SESSION_MAX_IN_FLIGHT 1024
+
+namespace LinkWirelessSession {
+
+struct Scenario {
+  u32 players = 2;
+  bool retransmission = true;
+  u32 lossRate = 0;        // (per 1000 transfers)
+  u32 reorderRate = 0;     // (per 1000 transfers)
+  u32 corruptionRate = 0;  // (per 1000 words)
+  u32 corruptedBits = 1;   // (flipped bits per corrupted word)
+  u32 senders = 0xff;      // (bit mask of the players that send)
+  u32 sendInterval = 0;    // (ticks between messages; 0 = fill the queue)
+  u32 readInterval = 1;    // (ticks between `receive(...)` calls)
+  u32 ticks = 3000;
+  u32 cooldownTicks = 600;  // (at the end, without new messages)
+
+  // (every sender -> receiver pair must get at least this throughput with
+  //  full queues, or keep up with `sendInterval`, and this latency)
+  double minThroughput = 0.5;                       // (msgs/transfer)
+  double maxLatency = LINK_WIRELESS_QUEUE_SIZE * 4;  // (transfers)
+};
+
+struct Result {
+  u32 sent[LINK_WIRELESS_MAX_PLAYERS];
+  u32 received[LINK_WIRELESS_MAX_PLAYERS][LINK_WIRELESS_MAX_PLAYERS];
+  u32 errors[LINK_WIRELESS_MAX_PLAYERS][LINK_WIRELESS_MAX_PLAYERS];
+  u64 latencyTicks[LINK_WIRELESS_MAX_PLAYERS][LINK_WIRELESS_MAX_PLAYERS];
+
+  // (messages from `senderId` that reached `id`, per transfer)
+  double throughput(u32 id, u32 senderId, const Scenario& scenario) const {
+    return (double)received[id][senderId] /
+           (scenario.ticks - scenario.cooldownTicks);
+  }
+
+  // (from the `send(...)` call to the `receive(...)` call, in transfers)
+  double latency(u32 id, u32 senderId) const {
+    return (double)latencyTicks[id][senderId] /
+           std::max(received[id][senderId], 1u);
+  }
+};
+
+inline u32 sentAt[LINK_WIRELESS_MAX_PLAYERS]
+                 [LINK_WIRELESS_SESSION_MAX_IN_FLIGHT];
+
+inline bool isSender(const Scenario& scenario, u32 id) {
+  return (scenario.senders >> id) & 1;
+}
+
+inline u16 messageOf(u32 sequence) {
+  return 1 + (sequence & LINK_WIRELESS_SESSION_SEQUENCE_MASK);
+}
+
+inline Result run(const Scenario& scenario) {
+  LinkWirelessLoopback loopback(scenario.players, true,
+                                scenario.retransmission);
+  loopback.lossRate = scenario.lossRate;
+  loopback.reorderRate = scenario.reorderRate;
+  loopback.corruptionRate = scenario.corruptionRate;
+  loopback.corruptedBits = scenario.corruptedBits;
+
+  Result result = {};
+  u32 expected[LINK_WIRELESS_MAX_PLAYERS][LINK_WIRELESS_MAX_PLAYERS] = {};
+
+  for (u32 tick = 0; tick < scenario.ticks; tick++) {
+    bool isCooldown = tick >= scenario.ticks - scenario.cooldownTicks;
+    bool isSendTick =
+        scenario.sendInterval == 0 || tick % scenario.sendInterval == 0;
+
+    for (u32 id = 0; id < scenario.players && !isCooldown && isSendTick;
+         id++) {
+      if (!isSender(scenario, id))
+        continue;
+
+      LinkWireless* node = loopback.nodes[id];
+      do {
+        u32 sequence = result.sent[id];
+        if (!node->send(messageOf(sequence)))
+          break;
+        sentAt[id][sequence % LINK_WIRELESS_SESSION_MAX_IN_FLIGHT] = tick;
+        result.sent[id]++;
+      } while (scenario.sendInterval == 0);
+    }
+
+    loopback.tick();
+
+    for (u32 id = 0; id < scenario.players; id++) {
+      if ((tick + id) % scenario.readInterval != 0)
+        continue;
+
+      LinkWireless::Message messages[LINK_WIRELESS_LOOPBACK_MAX_MESSAGES];
+      u32 count = loopback.receive(id, messages);
+      for (u32 i = 0; i < count; i++) {
+        u32 senderId = messages[i].playerId;
+        u32 sequence = expected[id][senderId];
+        if (senderId >= scenario.players ||
+            messages[i].data != messageOf(sequence)) {
+          result.errors[id][std::min(senderId, scenario.players - 1)]++;
+          continue;
+        }
+
+        expected[id][senderId]++;
+        result.received[id][senderId]++;
+        result.latencyTicks[id][senderId] +=
+            tick - sentAt[senderId]
+                         [sequence % LINK_WIRELESS_SESSION_MAX_IN_FLIGHT];
+      }
+    }
+  }
+
+  return result;
+}
+
+inline void check(const Scenario& scenario, const Result& result) {
+  for (u32 id = 0; id < scenario.players; id++) {
+    for (u32 senderId = 0; senderId < scenario.players; senderId++) {
+      if (senderId == id || !isSender(scenario, senderId))
+        continue;
+
+      LINK_HOST_CHECK(result.errors[id][senderId] == 0,
+                      "#%d got %d wrong messages from #%d", id,
+                      result.errors[id][senderId], senderId);
+      LINK_HOST_CHECK(
+          result.received[id][senderId] == result.sent[senderId],
+          "#%d got %d of %d messages from #%d", id,
+          result.received[id][senderId], result.sent[senderId], senderId);
+
+      // (a stream that stalls behind the others still arrives complete, so
+      //  it's caught by its throughput and latency)
+      double minThroughput = scenario.sendInterval > 0
+                                 ? 0.9 / scenario.sendInterval
+                                 : scenario.minThroughput;
+      double throughput = result.throughput(id, senderId, scenario);
+      double latency = result.latency(id, senderId);
+      LINK_HOST_CHECK(throughput >= minThroughput,
+                      "#%d -> #%d: %.2f msgs/transfer (min: %.2f)", senderId,
+                      id, throughput, minThroughput);
+      LINK_HOST_CHECK(latency <= scenario.maxLatency,
+                      "#%d -> #%d: %.2f transfers of latency (max: %.2f)",
+                      senderId, id, latency, scenario.maxLatency);
+    }
+  }
+}
+
+}  // namespace LinkWirelessSession
+
+#endif  // LINK_WIRELESS_SESSION_H
@@ -0,0 +1,170 @@
+#include <tonc.h>
+#include "LinkHostTest.h"
+
+// ASYNC:
+// Checks, with fake adapters, that `activateAsync()` brings the adapter up
+// from the interrupts, that calling it again during the bring-up restarts
+// it instead of giving up, and that an adapter that can't start fails
+// once, with an error, instead of retrying forever or looking started. Also,
+// that the lobby calls made during the bring-up fail right away (without
+// I/O or restarting the adapter), and that `serve(...)` works after it.
+
+#include "../../LinkWireless.h"
+#include "LinkWirelessFakeAdapter.h"
+
+#define GBA 0
+#define MAX_START_FRAMES 10
+#define IDLE_FRAMES 30
+#define MAX_SERVE_FRAMES 3
+#define LOGIN_CYCLES (LINK_HOST_CYCLES_PER_LINE * 4)
+
+LinkHostBus* linkHostBus = new LinkHostBus(2);
+
+LinkWireless wireless;
+
+void activate() {
+  irq_init(NULL);
+  irq_add(II_VBLANK, LinkWireless::ISR<wireless>::VBLANK);
+  irq_add(II_SERIAL, LinkWireless::ISR<wireless>::SERIAL);
+  irq_add(II_TIMER3, LinkWireless::ISR<wireless>::TIMER);
+  wireless.activateAsync();
+}
+
+u32 waitWhileAuthenticating() {
+  u32 frames = 0;
+  while (frames < MAX_START_FRAMES &&
+         wireless.getState() == LinkWireless::State::AUTHENTICATING) {
+    linkHostBus->waitVBlank();
+    frames++;
+  }
+  return frames;
+}
+
+void start() {
+  LinkWirelessFakeAdapter::install(1);
+  linkHostBus->runOn(GBA, activate);
+  u32 frames = waitWhileAuthenticating();
+
+  printf("  started in %d frames\n", frames);
+
+  LINK_HOST_CHECK(wireless.getState() == LinkWireless::State::AUTHENTICATED,
+                  "the adapter didn't start (state: %d, error: %d)",
+                  wireless.getState(), wireless.getLastError(false));
+  LINK_HOST_CHECK(wireless.getLastError(false) == LinkWireless::NONE,
+                  "it started with an error (%d)",
+                  wireless.getLastError(false));
+}
+
+void restartWhileAuthenticating() {
+  LinkWirelessFakeAdapter::install(1);
+  LinkWirelessFakeAdapter& adapter = LinkWirelessFakeAdapter::of(GBA);
+  linkHostBus->runOn(GBA, activate);
+
+  // (the second call arrives in the middle of the login, after the ping)
+  while (adapter.restarts == 1 ||
+         linkHostBus->getMode(GBA) == LinkHostBus::Mode::GENERAL_PURPOSE)
+    linkHostBus->wait(LINK_HOST_CYCLES_PER_LINE);
+  linkHostBus->wait(LOGIN_CYCLES);
+  u32 restarts = adapter.restarts;
+  linkHostBus->runOn(GBA, []() { wireless.activateAsync(); });
+  u32 frames = waitWhileAuthenticating();
+
+  printf("  restarted in %d frames\n", frames);
+
+  LINK_HOST_CHECK(adapter.restarts > restarts,
+                  "the second activateAsync() didn't restart the adapter");
+  LINK_HOST_CHECK(wireless.getState() == LinkWireless::State::AUTHENTICATED,
+                  "the restart gave up (state: %d, error: %d)",
+                  wireless.getState(), wireless.getLastError(false));
+}
+
+void failToStart() {
+  LinkWirelessFakeAdapter::install(1);
+  LinkWirelessFakeAdapter& adapter = LinkWirelessFakeAdapter::of(GBA);
+  adapter.isBroken = true;
+  linkHostBus->runOn(GBA, activate);
+  waitWhileAuthenticating();
+  u32 restarts = adapter.restarts;
+  for (u32 frame = 0; frame < IDLE_FRAMES; frame++)
+    linkHostBus->waitVBlank();
+
+  printf("  broken adapter: error %d, %d restarts\n",
+         wireless.getLastError(false), adapter.restarts);
+
+  LINK_HOST_CHECK(wireless.getState() == LinkWireless::State::NEEDS_RESET,
+                  "the state is %d", wireless.getState());
+  LINK_HOST_CHECK(wireless.getLastError(false) == LinkWireless::COMMAND_FAILED,
+                  "the error is %d", wireless.getLastError(false));
+  LINK_HOST_CHECK(adapter.restarts == restarts,
+                  "it kept restarting the adapter (%d more times)",
+                  adapter.restarts - restarts);
+}
+
+// (runs a lobby call and checks that it didn't talk to the adapter)
+template <typename F>
+bool runWithoutIO(const char* name, F action) {
+  u64 cycles = linkHostBus->getCycles();
+  bool success = false;
+  linkHostBus->runOn(GBA, [&]() { success = action(); });
+
+  LINK_HOST_CHECK(linkHostBus->getCycles() == cycles,
+                  "%s() took %llu cycles of I/O", name,
+                  (unsigned long long)(linkHostBus->getCycles() - cycles));
+  return success;
+}
+
+void lobbyWhileAuthenticating() {
+  LinkWirelessFakeAdapter::install(1);
+  LinkWirelessFakeAdapter& adapter = LinkWirelessFakeAdapter::of(GBA);
+  linkHostBus->runOn(GBA, activate);
+  u32 restarts = adapter.restarts;
+
+  bool didServe = runWithoutIO("serve", []() { return wireless.serve(); });
+  bool didConnect =
+      runWithoutIO("connect", []() { return wireless.connect(1); });
+  bool didSearch = runWithoutIO(
+      "getServersAsyncStart", []() { return wireless.getServersAsyncStart(); });
+
+  LINK_HOST_CHECK(!didServe && !didConnect && !didSearch,
+                  "a lobby call succeeded while authenticating");
+  LINK_HOST_CHECK(wireless.getLastError(false) == LinkWireless::WRONG_STATE,
+                  "the error is %d", wireless.getLastError(false));
+  LINK_HOST_CHECK(adapter.restarts == restarts,
+                  "a lobby call restarted the adapter");
+
+  waitWhileAuthenticating();
+  LINK_HOST_CHECK(wireless.getState() == LinkWireless::State::AUTHENTICATED,
+                  "the bring-up was interrupted (state: %d, error: %d)",
+                  wireless.getState(), wireless.getLastError(false));
+
+  didServe = runWithoutIO("serve", []() { return wireless.serve("Async"); });
+  u32 frames = 0;
+  while (frames < MAX_SERVE_FRAMES &&
+         adapter.commands[LINK_WIRELESS_COMMAND_START_HOST] == 0) {
+    linkHostBus->waitVBlank();
+    frames++;
+  }
+
+  printf("  served %d frames after the bring-up\n", frames);
+
+  LINK_HOST_CHECK(didServe &&
+                      wireless.getState() == LinkWireless::State::SERVING,
+                  "serve() failed (state: %d, error: %d)", wireless.getState(),
+                  wireless.getLastError(false));
+  LINK_HOST_CHECK(adapter.commands[LINK_WIRELESS_COMMAND_BROADCAST] == 1 &&
+                      adapter.commands[LINK_WIRELESS_COMMAND_START_HOST] == 1,
+                  "the host wasn't started (%d broadcasts, %d starts)",
+                  adapter.commands[LINK_WIRELESS_COMMAND_BROADCAST],
+                  adapter.commands[LINK_WIRELESS_COMMAND_START_HOST]);
+}
+
+int main() {
+  printf("LinkWireless_async\n");
+
+  start();
+  restartWhileAuthenticating();
+  failToStart();
+  lobbyWhileAuthenticating();
+
+  return LinkHostTest::result();
+}
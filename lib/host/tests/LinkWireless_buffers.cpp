@@ -0,0 +1,207 @@
+#include <tonc.h>
+
+// BUFFERS:
+// Checks that LinkWireless' byte buffers (longer than the queues, so they're
+// split across transfers) arrive complete and in order, that their words
+// never show up as messages, and that messages sent between buffers aren't
+// lost, when transfers get lost or reordered, when the server forwards them,
+// and when the receiver doesn't read its queue for a while (so it fills up).
+// Also, that unread buffers from one player don't hold back the messages of
+// the others, and that `send(0xFFFE)` is refused.
+
+#define LINK_WIRELESS_ENABLE_BUFFERS 1
+#include "LinkWirelessLoopback.h"
+
+#define TICKS 6000
+#define COOLDOWN_TICKS 600
+#define SEQUENCE_MASK 0x7fff
+#define MAX_LENGTH 200
+#define HOLD_TICKS 300
+#define MAX_HOLD_DELAY 4  // (#2's messages in flight, in ticks)
+
+LinkHostBus* linkHostBus = new LinkHostBus(1);
+
+struct Stream {
+  u32 sentMessages;
+  u32 sentBuffers;
+  u32 expectedMessage[LINK_WIRELESS_MAX_PLAYERS];
+  u32 expectedBuffer[LINK_WIRELESS_MAX_PLAYERS];
+  u32 receivedMessages[LINK_WIRELESS_MAX_PLAYERS];
+  u32 receivedBuffers[LINK_WIRELESS_MAX_PLAYERS];
+  u32 errors[LINK_WIRELESS_MAX_PLAYERS];
+};
+
+Stream streams[LINK_WIRELESS_MAX_PLAYERS];
+
+u32 fillBuffer(u8* bytes, u32 senderId, u32 sequence) {
+  // (lots of 0xFF and 0xFE bytes, so 0xFFFF and 0xFFFE words get escaped)
+  u32 length = 1 + (sequence * 7 + senderId * 3) % MAX_LENGTH;
+  for (u32 i = 0; i < length; i++)
+    bytes[i] = i % 3 == 0 ? 0xff : i % 3 == 1 ? 0xfe : sequence + i;
+  bytes[0] = sequence;
+  return length;
+}
+
+bool readBuffer(LinkWireless& node, u32 senderId, u32 sequence) {
+  u8 bytes[MAX_LENGTH];
+  u8 expectedBytes[MAX_LENGTH];
+  u32 length = node.readBuffer(senderId, bytes, MAX_LENGTH);
+  u32 expectedLength = fillBuffer(expectedBytes, senderId, sequence);
+  bool isValid = length == expectedLength;
+  for (u32 i = 0; isValid && i < length; i++)
+    isValid = bytes[i] == expectedBytes[i];
+  return isValid;
+}
+
+void run(u32 players, u32 lossRate, u32 reorderRate, u32 readInterval) {
+  LinkWirelessLoopback loopback(players, true, true);
+  loopback.lossRate = lossRate;
+  loopback.reorderRate = reorderRate;
+  for (u32 i = 0; i < players; i++)
+    streams[i] = Stream{};
+
+  for (u32 tick = 0; tick < TICKS; tick++) {
+    for (u32 id = 0; id < players; id++) {
+      Stream& stream = streams[id];
+      LinkWireless* node = loopback.nodes[id];
+      if (tick >= TICKS - COOLDOWN_TICKS)
+        break;
+
+      if ((tick + id) % 4 == 0) {
+        u8 bytes[MAX_LENGTH];
+        u32 length = fillBuffer(bytes, id, stream.sentBuffers);
+        if (node->send(bytes, length))
+          stream.sentBuffers++;
+      } else if (node->send(1 + (stream.sentMessages & SEQUENCE_MASK))) {
+        stream.sentMessages++;
+      }
+    }
+
+    loopback.tick();
+
+    for (u32 id = 0; id < players; id++) {
+      Stream& stream = streams[id];
+      if ((tick + id) % readInterval != 0)
+        continue;
+
+      LinkWireless::Message messages[LINK_WIRELESS_LOOPBACK_MAX_MESSAGES];
+      u32 count = loopback.receive(id, messages);
+      for (u32 i = 0; i < count; i++) {
+        u8 senderId = messages[i].playerId;
+        u32 expected = 1 + (stream.expectedMessage[senderId] & SEQUENCE_MASK);
+        if (messages[i].data == expected) {
+          stream.expectedMessage[senderId]++;
+          stream.receivedMessages[senderId]++;
+        } else {
+          stream.errors[senderId]++;
+        }
+      }
+
+      for (u32 senderId = 0; senderId < players; senderId++) {
+        if (!loopback.nodes[id]->canReadBuffer(senderId))
+          continue;
+
+        if (readBuffer(*loopback.nodes[id], senderId,
+                       stream.expectedBuffer[senderId]))
+          stream.receivedBuffers[senderId]++;
+        else
+          stream.errors[senderId]++;
+        stream.expectedBuffer[senderId]++;
+      }
+    }
+  }
+
+  printf("  %d players, %d/1000 lost, %d/1000 reordered, reading every %d: ",
+         players, lossRate, reorderRate, readInterval);
+  printf("%d buffers sent by #1\n", streams[1].sentBuffers);
+
+  for (u32 id = 0; id < players; id++) {
+    for (u32 senderId = 0; senderId < players; senderId++) {
+      if (senderId == id)
+        continue;
+      Stream& stream = streams[id];
+      Stream& sender = streams[senderId];
+
+      LINK_HOST_CHECK(stream.errors[senderId] == 0,
+                      "#%d got %d invalid messages or buffers from #%d", id,
+                      stream.errors[senderId], senderId);
+      LINK_HOST_CHECK(stream.receivedMessages[senderId] == sender.sentMessages,
+                      "#%d got %d of %d messages from #%d", id,
+                      stream.receivedMessages[senderId], sender.sentMessages,
+                      senderId);
+      LINK_HOST_CHECK(stream.receivedBuffers[senderId] == sender.sentBuffers,
+                      "#%d got %d of %d buffers from #%d", id,
+                      stream.receivedBuffers[senderId], sender.sentBuffers,
+                      senderId);
+    }
+  }
+}
+
+// (reads every node's messages, and returns how many #2 sent to #0)
+u32 receiveAll(LinkWirelessLoopback& loopback, u32& expectedMessage) {
+  u32 errors = 0;
+  for (u32 id = 0; id < 3; id++) {
+    LinkWireless::Message messages[LINK_WIRELESS_LOOPBACK_MAX_MESSAGES];
+    u32 count = loopback.receive(id, messages);
+    for (u32 i = 0; i < count && id == 0; i++) {
+      if (messages[i].playerId == 2 && messages[i].data == 1 + expectedMessage)
+        expectedMessage++;
+      else
+        errors++;
+    }
+  }
+  return errors;
+}
+
+void holdBuffers() {
+  // (#1 sends two buffers that the server doesn't read for a while, and #2
+  //  sends one message per tick meanwhile)
+  LinkWirelessLoopback loopback(3, true, true);
+  LinkWireless& server = *loopback.nodes[0];
+  u32 sentBuffers = 0, sentMessages = 0, receivedMessages = 0, errors = 0;
+  for (u32 tick = 0; tick < HOLD_TICKS; tick++) {
+    u8 bytes[MAX_LENGTH];
+    u32 length = fillBuffer(bytes, 1, sentBuffers);
+    if (sentBuffers < 2 && loopback.nodes[1]->send(bytes, length))
+      sentBuffers++;
+    if (loopback.nodes[2]->send(1 + sentMessages))
+      sentMessages++;
+
+    loopback.tick();
+    errors += receiveAll(loopback, receivedMessages);
+  }
+
+  printf("  two unread buffers from #1: %d of %d messages from #2 read\n",
+         receivedMessages, sentMessages);
+
+  LINK_HOST_CHECK(errors == 0, "#0 got %d invalid messages", errors);
+  LINK_HOST_CHECK(sentBuffers == 2 && !loopback.nodes[1]->isSendingBuffer(),
+                  "#1 couldn't send its buffers (%d sent)", sentBuffers);
+  LINK_HOST_CHECK(receivedMessages + MAX_HOLD_DELAY >= sentMessages,
+                  "the unread buffers held back #2's messages");
+
+  // (once the first buffer is read, the second one can be read too)
+  bool isFirstValid = readBuffer(server, 1, 0);
+  bool isSecondValid = server.canReadBuffer(1) && readBuffer(server, 1, 1);
+  LINK_HOST_CHECK(isFirstValid && isSecondValid,
+                  "the buffers are wrong (first: %d, second: %d)",
+                  isFirstValid, isSecondValid);
+
+  bool didSend = loopback.nodes[1]->send(LINK_WIRELESS_MSG_BUFFER);
+  LINK_HOST_CHECK(!didSend && loopback.nodes[1]->getLastError() ==
+                                  LinkWireless::RESERVED_DATA,
+                  "send(0xFFFE) wasn't refused");
+}
+
+int main() {
+  printf("LinkWireless_buffers\n");
+
+  run(2, 0, 0, 1);
+  run(2, 200, 100, 1);
+  run(3, 0, 0, 1);
+  run(3, 200, 100, 1);
+  run(3, 100, 50, 7);  // (the incoming queues get full)
+  holdBuffers();
+
+  return LinkHostTest::result();
+}
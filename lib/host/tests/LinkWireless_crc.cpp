@@ -0,0 +1,95 @@
+#include <tonc.h>
+
+// CRC:
+// Checks that, with `LINK_WIRELESS_USE_TRANSFER_CRC`, corrupted transfers are
+// discarded (so no wrong message gets through and retransmission recovers
+// them), and that when one client's transfer is corrupted, the server still
+// reads the transfers of the other clients in the same ReceiveData.
+// (CRC-16 catches every error of up to 3 bits in a transfer, but 1 in 65536
+//  bigger ones get through, so the corruption rates are kept low enough to
+//  make that unlikely in these runs)
+
+#define LINK_WIRELESS_USE_TRANSFER_CRC 1
+#include "LinkWirelessSession.h"
+
+#define CORRUPTED_CLIENT 2
+
+LinkHostBus* linkHostBus = new LinkHostBus(1);
+
+using LinkWirelessSession::Result;
+using LinkWirelessSession::Scenario;
+
+void measure(Scenario scenario) {
+  Result result = LinkWirelessSession::run(scenario);
+
+  printf("  %d players, %d/1000 lost, %d/1000 words with %d flipped bits: ",
+         scenario.players, scenario.lossRate, scenario.corruptionRate,
+         scenario.corruptedBits);
+  printf("#0 -> #1: %.2f msgs/transfer\n", result.throughput(1, 0, scenario));
+
+  LinkWirelessSession::check(scenario, result);
+}
+
+void corruptOneClient() {
+  LinkWirelessLoopback loopback(4, true, true);
+  LinkWireless& server = *loopback.nodes[0];
+  for (u32 id = 1; id < 4; id++)
+    loopback.nodes[id]->send(0x100 + id);
+
+  // (the server's ReceiveData has one header with the byte count of each
+  //  client, and then their transfers, with #2's one corrupted)
+  LinkWirelessLoopback::CommandResult data;
+  data.success = true;
+  data.responses[0] = 0;
+  data.responsesSize = 1;
+  for (u32 id = 1; id < 4; id++) {
+    LinkWirelessLoopback::CommandResult transfer = loopback.build(id);
+
+    data.responses[0] |= transfer.responses[0];
+    for (u32 i = 1; i < transfer.responsesSize; i++)
+      data.responses[data.responsesSize++] = transfer.responses[i];
+    if (id == CORRUPTED_CLIENT)
+      data.responses[data.responsesSize - 1] ^= 1 << 20;
+  }
+
+  u32 invalidTransfers = server.getStats().invalidTransfers;
+  loopback.receiveTransfer(0, data);
+
+  bool didReceive[LINK_WIRELESS_MAX_PLAYERS] = {};
+  LinkWireless::Message messages[LINK_WIRELESS_LOOPBACK_MAX_MESSAGES];
+  u32 count = loopback.receive(0, messages);
+  for (u32 i = 0; i < count; i++)
+    didReceive[messages[i].playerId] |=
+        messages[i].data == 0x100 + messages[i].playerId;
+
+  printf("  one corrupted client: %d of 3 messages read\n", count);
+
+  LINK_HOST_CHECK(
+      server.getStats().invalidTransfers == invalidTransfers + 1,
+      "%d transfers were discarded, instead of 1",
+      server.getStats().invalidTransfers - invalidTransfers);
+  LINK_HOST_CHECK(didReceive[1] && didReceive[3],
+                  "the other clients' messages were dropped (#1: %d, #3: %d)",
+                  didReceive[1], didReceive[3]);
+  LINK_HOST_CHECK(!didReceive[CORRUPTED_CLIENT],
+                  "the corrupted transfer was read");
+}
+
+int main() {
+  printf("LinkWireless_crc\n");
+
+  for (u32 players = 2; players <= LINK_WIRELESS_MAX_PLAYERS; players++) {
+    Scenario scenario;
+    scenario.players = players;
+    scenario.corruptionRate = 20;
+    measure(scenario);
+
+    scenario.corruptedBits = 2;
+    scenario.lossRate = 100;
+    measure(scenario);
+  }
+
+  corruptOneClient();
+
+  return LinkHostTest::result();
+}
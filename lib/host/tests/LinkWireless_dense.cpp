@@ -0,0 +1,64 @@
+#include <tonc.h>
+
+// DENSE FRAMING:
+// Checks that, with `LINK_WIRELESS_USE_DENSE_FRAMING`, every message of every
+// player arrives once and in order (frames split and resent by go-back-N,
+// and packed payloads), with 2 to 5 players, when transfers get lost, and
+// when the receivers don't read their queues on every frame. Transfers are
+// never reordered here: adapters deliver them in order, and a server
+// transfer can carry up to 36 messages, so a resent one that arrives after
+// the next transfer can be 64 packet ids behind, which 6-bit ids can't tell
+// apart from new messages.
+
+#define LINK_WIRELESS_USE_DENSE_FRAMING 1
+#include "LinkWirelessSession.h"
+
+LinkHostBus* linkHostBus = new LinkHostBus(1);
+
+using LinkWirelessSession::Result;
+using LinkWirelessSession::Scenario;
+
+void measure(Scenario scenario) {
+  Result result = LinkWirelessSession::run(scenario);
+
+  printf("  %d players, %d/1000 lost, reading every %d: ", scenario.players,
+         scenario.lossRate, scenario.readInterval);
+  printf("#0 -> #1: %.2f msgs/transfer, %.2f transfers of latency\n",
+         result.throughput(1, 0, scenario), result.latency(1, 0));
+
+  LinkWirelessSession::check(scenario, result);
+}
+
+int main() {
+  printf("LinkWireless_dense\n");
+
+  for (u32 players = 2; players <= LINK_WIRELESS_MAX_PLAYERS; players++) {
+    Scenario scenario;
+    scenario.players = players;
+    measure(scenario);
+
+    scenario.lossRate = 200;
+    measure(scenario);
+
+    scenario.lossRate = 500;
+    measure(scenario);
+  }
+
+  // (only the server and #1 send, so the other clients confirm nothing
+  //  of their own)
+  Scenario scenario;
+  scenario.players = 5;
+  scenario.senders = 0b11;
+  scenario.lossRate = 200;
+  measure(scenario);
+
+  // (the incoming queues get full)
+  scenario = Scenario{};
+  scenario.players = 4;
+  scenario.lossRate = 100;
+  scenario.sendInterval = 2;
+  scenario.readInterval = 7;
+  measure(scenario);
+
+  return LinkHostTest::result();
+}
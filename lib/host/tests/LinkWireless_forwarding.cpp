@@ -0,0 +1,92 @@
+#include <tonc.h>
+
+// FORWARDING:
+// Checks that, with `LINK_WIRELESS_USE_ISR_FORWARDING`, the server forwards
+// client messages without waiting for its game loop to read them, and that
+// every client gets a fair share of the outgoing queue (complete and in
+// order) when the server fills it with its own messages, under loss, and
+// when the server doesn't read its queue for a while.
+
+#define LINK_WIRELESS_USE_ISR_FORWARDING 1
+#include "LinkWirelessSession.h"
+
+#define MIN_CLIENT_THROUGHPUT 1.0  // (msgs/transfer, with full queues)
+#define MIN_FAIRNESS 0.8           // (slowest client / fastest client)
+
+LinkHostBus* linkHostBus = new LinkHostBus(1);
+
+using LinkWirelessSession::Result;
+using LinkWirelessSession::Scenario;
+
+void measure(Scenario scenario, double maxLatency) {
+  Result result = LinkWirelessSession::run(scenario);
+
+  // (client-to-client streams, which are always forwarded)
+  double minThroughput = 1000, maxThroughput = 0, latency = 0;
+  u32 streams = 0;
+  for (u32 id = 1; id < scenario.players; id++) {
+    for (u32 senderId = 1; senderId < scenario.players; senderId++) {
+      if (senderId == id || !LinkWirelessSession::isSender(scenario, senderId))
+        continue;
+
+      double throughput = result.throughput(id, senderId, scenario);
+      minThroughput = std::min(minThroughput, throughput);
+      maxThroughput = std::max(maxThroughput, throughput);
+      latency += result.latency(id, senderId);
+      streams++;
+    }
+  }
+  latency /= streams;
+
+  printf("  %d players, %d/1000 lost, reading every %d: ", scenario.players,
+         scenario.lossRate, scenario.readInterval);
+  printf("%.2f-%.2f msgs/transfer, %.2f transfers of latency\n",
+         minThroughput, maxThroughput, latency);
+
+  LinkWirelessSession::check(scenario, result);
+  LINK_HOST_CHECK(latency <= maxLatency,
+                  "the clients' messages took %.2f transfers (max: %.2f)",
+                  latency, maxLatency);
+  LINK_HOST_CHECK(minThroughput >= MIN_FAIRNESS * maxThroughput,
+                  "a client only got %.2f msgs/transfer (the fastest: %.2f)",
+                  minThroughput, maxThroughput);
+  if (scenario.sendInterval == 0)
+    LINK_HOST_CHECK(minThroughput >= MIN_CLIENT_THROUGHPUT,
+                    "the server starved a client (%.2f msgs/transfer)",
+                    minThroughput);
+}
+
+int main() {
+  printf("LinkWireless_forwarding\n");
+
+  // (the server only forwards, and its game loop reads every 3 transfers;
+  //  forwarding from `receive(...)` takes 3.00 transfers, 3.22 with loss)
+  Scenario scenario;
+  scenario.players = 4;
+  scenario.senders = 0b1110;
+  scenario.sendInterval = 2;
+  scenario.readInterval = 3;
+  measure(scenario, scenario.readInterval - 0.5);
+
+  scenario.lossRate = 100;
+  measure(scenario, scenario.readInterval - 0.5);
+
+  // (everyone fills their queues, so the clients' messages compete with the
+  //  server's own messages for the free slots)
+  for (u32 players = 3; players <= LINK_WIRELESS_MAX_PLAYERS; players++) {
+    scenario = Scenario{};
+    scenario.players = players;
+    measure(scenario, LINK_WIRELESS_QUEUE_SIZE);
+
+    scenario.lossRate = 200;
+    measure(scenario, LINK_WIRELESS_QUEUE_SIZE * 2);
+  }
+
+  // (the incoming queues get full)
+  scenario = Scenario{};
+  scenario.players = 5;
+  scenario.readInterval = 7;
+  measure(scenario, LINK_WIRELESS_QUEUE_SIZE * 2);
+
+  return LinkHostTest::result();
+}
@@ -0,0 +1,161 @@
+#include <tonc.h>
+#include <string>
+#include "LinkHostTest.h"
+
+// LOBBY:
+// Checks, with fake adapters, that the asynchronous lobby (search, peek,
+// connect) runs from the interrupts: the user-side calls return without
+// doing any I/O, `peekServers(...)` shows the server while searching, the
+// client gets connected with a player id, and a console can `serve(...)`
+// right after ending a search (the interrupts send the pending
+// BroadcastReadEnd first, and then start the host).
+
+#include "../../LinkWireless.h"
+#include "LinkWirelessFakeAdapter.h"
+
+#define A 0
+#define B 2
+#define MAX_FRAMES 120
+#define MAX_SEARCH_FRAMES (LINK_WIRELESS_BROADCAST_POLL_FRAMES * 3)
+
+LinkHostBus* linkHostBus = new LinkHostBus(4);
+
+LinkWireless a, b;
+
+template <LinkWireless& instance>
+void activate() {
+  irq_init(NULL);
+  irq_add(II_VBLANK, LinkWireless::ISR<instance>::VBLANK);
+  irq_add(II_SERIAL, LinkWireless::ISR<instance>::SERIAL);
+  irq_add(II_TIMER3, LinkWireless::ISR<instance>::TIMER);
+  instance.activate();
+}
+
+void start() {
+  LinkWirelessFakeAdapter::install(2);
+  linkHostBus->runOn(A, activate<a>);
+  linkHostBus->runOn(B, activate<b>);
+}
+
+// (runs a user-side call and checks that it didn't talk to the adapter)
+template <typename F>
+bool runWithoutIO(u32 consoleId,
+                  LinkWireless& instance,
+                  const char* name,
+                  F action) {
+  u64 cycles = linkHostBus->getCycles();
+  bool success = false;
+  linkHostBus->runOn(consoleId, [&]() { success = action(); });
+
+  LINK_HOST_CHECK(linkHostBus->getCycles() == cycles,
+                  "%s() took %llu cycles of I/O", name,
+                  (unsigned long long)(linkHostBus->getCycles() - cycles));
+  LINK_HOST_CHECK(success, "%s() failed (error: %d)", name,
+                  instance.getLastError(false));
+  return success;
+}
+
+// (searches from `client` until `peekServers(...)` shows a server)
+u32 search(u32 consoleId, LinkWireless& client, LinkWireless::Server* servers) {
+  runWithoutIO(consoleId, client, "getServersAsyncStart",
+               [&]() { return client.getServersAsyncStart(); });
+  LINK_HOST_CHECK(client.getState() == LinkWireless::State::SEARCHING,
+                  "the state is %d", client.getState());
+
+  u32 frames = 0;
+  servers[0] = LinkWireless::Server{};
+  while (frames < MAX_SEARCH_FRAMES && servers[0].id == LINK_WIRELESS_END) {
+    linkHostBus->waitVBlank();
+    runWithoutIO(consoleId, client, "peekServers",
+                 [&]() { return client.peekServers(servers); });
+    frames++;
+  }
+  return frames;
+}
+
+void searchAndConnect() {
+  start();
+  runWithoutIO(A, a, "serve", []() { return a.serve("Lobby", "Host"); });
+
+  LinkWireless::Server servers[LINK_WIRELESS_MAX_SERVERS];
+  u32 frames = search(B, b, servers);
+  u32 polls = LinkWirelessFakeAdapter::of(B)
+                  .commands[LINK_WIRELESS_COMMAND_BROADCAST_READ_POLL];
+
+  printf("  found the server in %d frames (%d polls)\n", frames, polls);
+
+  LINK_HOST_CHECK(servers[0].id != LINK_WIRELESS_END,
+                  "peekServers() found nothing in %d frames", frames);
+  LINK_HOST_CHECK(std::string(servers[0].gameName) == "Lobby" &&
+                      std::string(servers[0].userName) == "Host",
+                  "the server's names are wrong");
+  LINK_HOST_CHECK(b.getState() == LinkWireless::State::SEARCHING,
+                  "peeking ended the search (state: %d)", b.getState());
+
+  runWithoutIO(B, b, "getServersAsyncEnd",
+               [&]() { return b.getServersAsyncEnd(servers); });
+  runWithoutIO(B, b, "connect", [&]() { return b.connect(servers[0].id); });
+
+  frames = 0;
+  while (frames < MAX_FRAMES &&
+         b.getState() != LinkWireless::State::CONNECTED) {
+    linkHostBus->waitVBlank();
+    runWithoutIO(B, b, "keepConnecting", []() { return b.keepConnecting(); });
+    frames++;
+  }
+
+  printf("  connected in %d frames\n", frames);
+
+  LINK_HOST_CHECK(b.getState() == LinkWireless::State::CONNECTED,
+                  "the client didn't connect (state: %d, error: %d)",
+                  b.getState(), b.getLastError(false));
+  LINK_HOST_CHECK(b.currentPlayerId() == 1, "the player id is %d",
+                  b.currentPlayerId());
+  LINK_HOST_CHECK(LinkWirelessFakeAdapter::of(B)
+                          .commands[LINK_WIRELESS_COMMAND_BROADCAST_READ_END] ==
+                      1,
+                  "the search wasn't ended before connecting");
+}
+
+void serveAfterSearch() {
+  start();
+
+  // (`b` stops searching and serves right away, so its adapter still has to
+  //  get the BroadcastReadEnd)
+  LinkWireless::Server servers[LINK_WIRELESS_MAX_SERVERS];
+  search(B, b, servers);
+  runWithoutIO(B, b, "getServersAsyncEnd",
+               [&]() { return b.getServersAsyncEnd(servers); });
+  runWithoutIO(B, b, "serve", []() { return b.serve("Swapped", "Client"); });
+
+  LinkWirelessFakeAdapter& adapter = LinkWirelessFakeAdapter::of(B);
+  u32 frames = 0;
+  while (frames < MAX_FRAMES &&
+         adapter.commands[LINK_WIRELESS_COMMAND_START_HOST] == 0) {
+    linkHostBus->waitVBlank();
+    frames++;
+  }
+
+  LINK_HOST_CHECK(b.getState() == LinkWireless::State::SERVING,
+                  "serve() failed (state: %d, error: %d)", b.getState(),
+                  b.getLastError(false));
+  LINK_HOST_CHECK(adapter.commands[LINK_WIRELESS_COMMAND_BROADCAST_READ_END] ==
+                      1,
+                  "the search wasn't ended before serving");
+  LINK_HOST_CHECK(adapter.commands[LINK_WIRELESS_COMMAND_START_HOST] == 1,
+                  "the host wasn't started in %d frames", frames);
+
+  search(A, a, servers);
+
+  LINK_HOST_CHECK(std::string(servers[0].gameName) == "Swapped",
+                  "the new server wasn't found");
+}
+
+int main() {
+  printf("LinkWireless_lobby\n");
+
+  searchAndConnect();
+  serveAfterSearch();
+
+  return LinkHostTest::result();
+}
@@ -0,0 +1,64 @@
+#include <tonc.h>
+
+// SESSION:
+// Checks that, with go-back-N retransmission, every message of every player
+// arrives once and in order, with 2 to 5 players, when transfers get lost or
+// reordered, when only some players send, and when the receivers don't read
+// their queues on every frame.
+
+#include "LinkWirelessSession.h"
+
+LinkHostBus* linkHostBus = new LinkHostBus(1);
+
+using LinkWirelessSession::Result;
+using LinkWirelessSession::Scenario;
+
+void measure(Scenario scenario) {
+  Result result = LinkWirelessSession::run(scenario);
+
+  printf("  %d players, %d/1000 lost, %d/1000 reordered, reading every %d: ",
+         scenario.players, scenario.lossRate, scenario.reorderRate,
+         scenario.readInterval);
+  printf("#0 -> #1: %.2f msgs/transfer, %.2f transfers of latency\n",
+         result.throughput(1, 0, scenario), result.latency(1, 0));
+
+  LinkWirelessSession::check(scenario, result);
+}
+
+int main() {
+  printf("LinkWireless_session\n");
+
+  // (the server forwards the clients' messages when it reads its queue, and
+  //  its own messages only get the slots left, so #0 -> #1 slows down as
+  //  more clients send under loss)
+  for (u32 players = 2; players <= LINK_WIRELESS_MAX_PLAYERS; players++) {
+    Scenario scenario;
+    scenario.players = players;
+    measure(scenario);
+
+    scenario.lossRate = 200;
+    measure(scenario);
+
+    scenario.reorderRate = 100;
+    measure(scenario);
+  }
+
+  // (only the server and #1 send, so the other clients confirm nothing
+  //  of their own)
+  Scenario scenario;
+  scenario.players = 5;
+  scenario.senders = 0b11;
+  scenario.lossRate = 200;
+  measure(scenario);
+
+  // (the incoming queues get full)
+  scenario = Scenario{};
+  scenario.players = 4;
+  scenario.lossRate = 100;
+  scenario.reorderRate = 50;
+  scenario.sendInterval = 2;
+  scenario.readInterval = 7;
+  measure(scenario);
+
+  return LinkHostTest::result();
+}
@@ -0,0 +1,65 @@
+#include <tonc.h>
+
+// SPARSE:
+// Checks that, with `LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS`, idle clients
+// don't take payload space from the server's transfers (with one active
+// client, the server only spends one word on confirmations), and that every
+// message still arrives once and in order when confirmations get lost.
+
+#define LINK_WIRELESS_USE_SPARSE_CONFIRMATIONS 1
+#include "LinkWirelessSession.h"
+
+// (the server's words, minus the active client's confirmation; without
+//  sparse confirmations, it's 15: one word per client and the sync word)
+#define MIN_SERVER_PAYLOAD (LINK_WIRELESS_MAX_SERVER_TRANSFER_LENGTH - 1)
+
+LinkHostBus* linkHostBus = new LinkHostBus(1);
+
+using LinkWirelessSession::Result;
+using LinkWirelessSession::Scenario;
+
+Result measure(Scenario scenario) {
+  Result result = LinkWirelessSession::run(scenario);
+
+  printf("  %d players, %d/1000 lost, %d/1000 reordered, senders 0x%x: ",
+         scenario.players, scenario.lossRate, scenario.reorderRate,
+         scenario.senders);
+  printf("#0 -> #1: %.2f msgs/transfer\n", result.throughput(1, 0, scenario));
+
+  LinkWirelessSession::check(scenario, result);
+  return result;
+}
+
+int main() {
+  printf("LinkWireless_sparse\n");
+
+  // (only the server and #1 send; #2 gets both streams in the server's
+  //  transfers, the forwarded one included)
+  Scenario scenario;
+  scenario.players = 5;
+  scenario.senders = 0b11;
+  Result result = measure(scenario);
+  double payload =
+      result.throughput(2, 0, scenario) + result.throughput(2, 1, scenario);
+
+  printf("  server payload with one active client: %.2f msgs/transfer\n",
+         payload);
+  LINK_HOST_CHECK(payload >= MIN_SERVER_PAYLOAD - 0.1,
+                  "the server only sent %.2f msgs/transfer (min: %d)", payload,
+                  MIN_SERVER_PAYLOAD);
+
+  for (u32 players = 2; players <= LINK_WIRELESS_MAX_PLAYERS; players++) {
+    scenario = Scenario{};
+    scenario.players = players;
+    scenario.lossRate = 200;
+    measure(scenario);
+
+    scenario.reorderRate = 100;
+    measure(scenario);
+
+    scenario.senders = 0b11;
+    measure(scenario);
+  }
+
+  return LinkHostTest::result();
+}
@@ -0,0 +1,215 @@
+#include <tonc.h>
+#include "LinkHostTest.h"
+
+// WAIT:
+// Measures, with fake adapters, how long the client takes to read each
+// transfer of the server (from the server's SendData to the client's
+// ReceiveData) and the round trip of a message between both game loops,
+// when clients use SendDataWait (this test) or poll with SendData and
+// ReceiveData (the `LinkWireless_wait_polling` build, see Makefile). With
+// SendDataWait, the round trip has to beat polling's 4 frames, since the
+// client's game loop gets the data before the next VBlank.
+// It also checks that an adapter that never answers the reversed ACK of a
+// Wait doesn't hold the client's serial IRQ for longer than ~800μs.
+
+#ifndef LINK_WIRELESS_USE_SEND_DATA_WAIT
+#define LINK_WIRELESS_USE_SEND_DATA_WAIT 1
+#endif
+#include "../../LinkWireless.h"
+#include "LinkWirelessFakeAdapter.h"
+
+#define SERVER 0
+#define CLIENT 2
+#define MAX_SETUP_FRAMES 120
+#define FRAMES 600
+#define MAX_ROUND_TRIP_FRAMES 10
+#define MAX_WAIT_DELIVERY_LINES 5
+#define MAX_WAIT_ROUND_TRIP_FRAMES 3.5
+#define MAX_SERIAL_IRQ_CYCLES LINK_HOST_CYCLES_PER_LINE
+#define MAX_WAIT_IRQ_CYCLES \
+  ((LINK_WIRELESS_REVERSE_ACK_TIMEOUT + 2) * LINK_HOST_CYCLES_PER_LINE)
+
+LinkHostBus* linkHostBus = new LinkHostBus(4);
+
+LinkWireless server, client;
+u64 longestClientSerialIRQ = 0;
+
+void clientSerialIRQ() {
+  u64 start = linkHostBus->getCycles();
+  LinkWireless::ISR<client>::SERIAL();
+  longestClientSerialIRQ =
+      std::max(longestClientSerialIRQ, linkHostBus->getCycles() - start);
+}
+
+template <LinkWireless& instance>
+void activate() {
+  irq_init(NULL);
+  irq_add(II_VBLANK, LinkWireless::ISR<instance>::VBLANK);
+  irq_add(II_SERIAL, &instance == &client
+                         ? clientSerialIRQ
+                         : LinkWireless::ISR<instance>::SERIAL);
+  irq_add(II_TIMER3, LinkWireless::ISR<instance>::TIMER);
+  instance.activate();
+}
+
+bool connect() {
+  LinkWirelessFakeAdapter::install(2);
+  linkHostBus->runOn(SERVER, activate<server>);
+  linkHostBus->runOn(CLIENT, activate<client>);
+
+  linkHostBus->runOn(SERVER, []() { server.serve("Latency", "Server"); });
+  linkHostBus->runOn(CLIENT, []() { client.getServersAsyncStart(); });
+
+  LinkWireless::Server servers[LINK_WIRELESS_MAX_SERVERS];
+  for (u32 frame = 0; frame < MAX_SETUP_FRAMES; frame++) {
+    linkHostBus->waitVBlank();
+    linkHostBus->runOn(CLIENT, [&servers]() { client.peekServers(servers); });
+    if (servers[0].id != LINK_WIRELESS_END)
+      break;
+  }
+
+  linkHostBus->runOn(CLIENT, [&servers]() {
+    client.getServersAsyncEnd(servers);
+    client.connect(servers[0].id);
+  });
+
+  for (u32 frame = 0; frame < MAX_SETUP_FRAMES; frame++) {
+    linkHostBus->waitVBlank();
+    if (client.isConnected() && server.isConnected())
+      return true;
+  }
+
+  LINK_HOST_CHECK(false, "the client didn't connect (states: %d, %d)",
+                  server.getState(), client.getState());
+  return false;
+}
+
+u32 receive(LinkWireless& linkWireless, u16* data) {
+  LinkWireless::Message messages[LINK_WIRELESS_MAX_TRANSFER_LENGTH];
+  linkWireless.receive(messages);
+
+  u32 count = 0;
+  while (count < LINK_WIRELESS_MAX_TRANSFER_LENGTH &&
+         messages[count].packetId != LINK_WIRELESS_END) {
+    data[count] = messages[count].data;
+    count++;
+  }
+  return count;
+}
+
+void measureLatency() {
+  if (!connect())
+    return;
+
+  // (the server sends a ping when the previous one comes back, and the
+  //  client echoes every ping it gets; both game loops run once per frame)
+  LinkWirelessFakeAdapter& clientAdapter = LinkWirelessFakeAdapter::of(CLIENT);
+  clientAdapter.deliveries = clientAdapter.deliveryCycles = 0;
+  clientAdapter.emptyReceives = clientAdapter.overwrites = 0;
+  u32 ping = 0, pingFrame = 0, roundTrips = 0, roundTripFrames = 0;
+  u32 maxRoundTripFrames = 0;
+
+  for (u32 frame = 0; frame < FRAMES; frame++) {
+    linkHostBus->runOn(SERVER, [&]() {
+      u16 data[LINK_WIRELESS_MAX_TRANSFER_LENGTH];
+      u32 count = receive(server, data);
+      for (u32 i = 0; i < count; i++) {
+        if (ping == 0 || data[i] != ping)
+          continue;
+        roundTrips++;
+        roundTripFrames += frame - pingFrame;
+        maxRoundTripFrames = std::max(maxRoundTripFrames, frame - pingFrame);
+        ping = 0;
+      }
+
+      if (ping == 0 || frame - pingFrame > MAX_ROUND_TRIP_FRAMES) {
+        ping = 1 + frame;
+        pingFrame = frame;
+        server.send(ping);
+      }
+    });
+
+    linkHostBus->runOn(CLIENT, []() {
+      u16 data[LINK_WIRELESS_MAX_TRANSFER_LENGTH];
+      u32 count = receive(client, data);
+      for (u32 i = 0; i < count; i++)
+        client.send(data[i]);
+    });
+
+    linkHostBus->waitVBlank();
+  }
+
+  double deliveryLines = (double)clientAdapter.deliveryCycles /
+                         clientAdapter.deliveries / LINK_HOST_CYCLES_PER_LINE;
+  printf("  server transfer -> client ReceiveData: %.1f lines (%d read, %d "
+         "overwritten)\n",
+         deliveryLines, clientAdapter.deliveries, clientAdapter.overwrites);
+  printf("  round trip: %.2f frames (max %d), %d empty ReceiveData\n",
+         (double)roundTripFrames / std::max(roundTrips, 1u), maxRoundTripFrames,
+         clientAdapter.emptyReceives);
+  printf("  longest client serial IRQ: %llu cycles\n",
+         (unsigned long long)longestClientSerialIRQ);
+
+  LINK_HOST_CHECK(client.isConnected() && server.isConnected(),
+                  "the session was lost (states: %d, %d)", server.getState(),
+                  client.getState());
+  LINK_HOST_CHECK(roundTrips > FRAMES / (MAX_ROUND_TRIP_FRAMES * 2),
+                  "only %d pings came back", roundTrips);
+  LINK_HOST_CHECK(maxRoundTripFrames <= MAX_ROUND_TRIP_FRAMES,
+                  "a ping took %d frames", maxRoundTripFrames);
+  LINK_HOST_CHECK(longestClientSerialIRQ <= MAX_SERIAL_IRQ_CYCLES,
+                  "the client's serial IRQ took %llu cycles (max: %d)",
+                  (unsigned long long)longestClientSerialIRQ,
+                  MAX_SERIAL_IRQ_CYCLES);
+#if LINK_WIRELESS_USE_SEND_DATA_WAIT
+  LINK_HOST_CHECK(roundTripFrames <= MAX_WAIT_ROUND_TRIP_FRAMES * roundTrips,
+                  "the round trip took %.2f frames (max: %.2f)",
+                  (double)roundTripFrames / std::max(roundTrips, 1u),
+                  MAX_WAIT_ROUND_TRIP_FRAMES);
+  LINK_HOST_CHECK(clientAdapter.emptyReceives == 0,
+                  "the client polled %d times without data",
+                  clientAdapter.emptyReceives);
+  LINK_HOST_CHECK(deliveryLines < MAX_WAIT_DELIVERY_LINES,
+                  "the client took %.1f lines to read the server's data",
+                  deliveryLines);
+#endif
+}
+
+#if LINK_WIRELESS_USE_SEND_DATA_WAIT
+void checkReverseAckTimeout() {
+  if (!connect())
+    return;
+
+  // (the adapter stops answering the ACK of its events, so the client fails
+  //  and restarts the adapter instead of spinning in its serial IRQ)
+  LinkWirelessFakeAdapter::of(CLIENT).ignoresReverseAck = true;
+  longestClientSerialIRQ = 0;
+  bool didFail = false;
+  for (u32 frame = 0; frame < MAX_SETUP_FRAMES && !didFail; frame++) {
+    linkHostBus->waitVBlank();
+    didFail = client.getLastError() == LinkWireless::ACKNOWLEDGE_FAILED;
+  }
+
+  printf("  ignored reverse ACK: %llu cycles in the serial IRQ\n",
+         (unsigned long long)longestClientSerialIRQ);
+
+  LINK_HOST_CHECK(didFail, "the client didn't fail (state: %d, error: %d)",
+                  client.getState(), client.getLastError());
+  LINK_HOST_CHECK(longestClientSerialIRQ <= MAX_WAIT_IRQ_CYCLES,
+                  "the serial IRQ took %llu cycles (max: %d)",
+                  (unsigned long long)longestClientSerialIRQ,
+                  MAX_WAIT_IRQ_CYCLES);
+}
+#endif
+
+int main() {
+  printf("LinkWireless_wait (SendDataWait: %d)\n",
+         LINK_WIRELESS_USE_SEND_DATA_WAIT);
+
+  measureLatency();
+#if LINK_WIRELESS_USE_SEND_DATA_WAIT
+  checkReverseAckTimeout();
+#endif
+
+  return LinkHostTest::result();
+}
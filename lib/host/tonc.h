@@ -0,0 +1,12 @@
+#ifndef LINK_HOST_TONC_H
+#define LINK_HOST_TONC_H
+
+// --------------------------------------------------------------------------
+// Host replacement of libtonc's <tonc.h> (see LinkHostBus.h).
+// --------------------------------------------------------------------------
+
+#include "tonc_bios.h"
+#include "tonc_core.h"
+#include "tonc_irq.h"
+
+#endif  // LINK_HOST_TONC_H
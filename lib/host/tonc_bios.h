@@ -0,0 +1,40 @@
+#ifndef LINK_HOST_TONC_BIOS_H
+#define LINK_HOST_TONC_BIOS_H
+
+// --------------------------------------------------------------------------
+// Host replacement of libtonc's <tonc_bios.h> (see LinkHostBus.h).
+// --------------------------------------------------------------------------
+
+#include "LinkHostBus.h"
+
+typedef struct {
+  u32 reserved1[5];
+  u8 handshake_data;
+  u8 padding;
+  u16 handshake_timeout;
+  u8 probe_count;
+  u8 client_data[3];
+  u8 palette_data;
+  u8 response_bit;
+  u8 client_bit;
+  u8 reserved2;
+  const u8* boot_srcp;
+  const u8* boot_endp;
+  const u8* masterp;
+  const u8* reserved3[3];
+  u32 system_work2[4];
+  u8 sendflag;
+  u8 probe_target_bit;
+  u8 check_wait;
+  u8 server_type;
+} MultiBootParam;
+
+inline void VBlankIntrWait() {
+  linkHostBus->waitVBlank();
+}
+
+inline int MultiBoot(MultiBootParam* mb, u32 mode) {
+  return 1;  // (the BIOS' multiboot protocol is not emulated)
+}
+
+#endif  // LINK_HOST_TONC_BIOS_H
@@ -0,0 +1,64 @@
+#ifndef LINK_HOST_TONC_CORE_H
+#define LINK_HOST_TONC_CORE_H
+
+// --------------------------------------------------------------------------
+// Host replacement of libtonc's <tonc_core.h> (see LinkHostBus.h).
+// --------------------------------------------------------------------------
+
+#include "LinkHostBus.h"
+
+#define REG_VCOUNT (LinkHostRegister16(LINK_HOST_REG_VCOUNT))
+#define REG_TM (LinkHostTimerArray{})
+#define REG_SIOMULTI (LinkHostRegister16Array{LINK_HOST_REG_SIOMULTI})
+#define REG_SIODATA32 (LinkHostRegister32(LINK_HOST_REG_SIODATA32))
+#define REG_SIOCNT (LinkHostRegister16(LINK_HOST_REG_SIOCNT))
+#define REG_SIOMLT_SEND (LinkHostRegister16(LINK_HOST_REG_SIOMLT_SEND))
+#define REG_KEYS (LinkHostRegister16(LINK_HOST_REG_KEYS))
+#define REG_KEYINPUT REG_KEYS
+#define REG_RCNT (LinkHostRegister16(LINK_HOST_REG_RCNT))
+
+#define TM_FREQ_1 0
+#define TM_FREQ_64 0x0001
+#define TM_FREQ_256 0x0002
+#define TM_FREQ_1024 0x0003
+#define TM_CASCADE 0x0004
+#define TM_IRQ 0x0040
+#define TM_ENABLE 0x0080
+
+#define IRQ_VBLANK 0x0001
+#define IRQ_HBLANK 0x0002
+#define IRQ_VCOUNT 0x0004
+#define IRQ_TIMER0 0x0008
+#define IRQ_TIMER1 0x0010
+#define IRQ_TIMER2 0x0020
+#define IRQ_TIMER3 0x0040
+#define IRQ_SERIAL 0x0080
+
+#define KEY_A 0x0001
+#define KEY_B 0x0002
+#define KEY_SELECT 0x0004
+#define KEY_START 0x0008
+#define KEY_RIGHT 0x0010
+#define KEY_LEFT 0x0020
+#define KEY_UP 0x0040
+#define KEY_DOWN 0x0080
+#define KEY_R 0x0100
+#define KEY_L 0x0200
+#define KEY_ANY 0x03ff
+
+#define QRAN_SHIFT 15
+#define QRAN_MASK ((1 << QRAN_SHIFT) - 1)
+#define QRAN_MAX QRAN_MASK
+
+inline int __qran_seed = 42;
+
+inline int qran() {
+  __qran_seed = 1664525 * __qran_seed + 1013904223;
+  return (__qran_seed >> 16) & QRAN_MAX;
+}
+
+inline int qran_range(int min, int max) {
+  return (qran() * (max - min) >> QRAN_SHIFT) + min;
+}
+
+#endif  // LINK_HOST_TONC_CORE_H
@@ -0,0 +1,44 @@
+#ifndef LINK_HOST_TONC_IRQ_H
+#define LINK_HOST_TONC_IRQ_H
+
+// --------------------------------------------------------------------------
+// Host replacement of libtonc's <tonc_irq.h> (see LinkHostBus.h).
+// --------------------------------------------------------------------------
+
+#include "LinkHostBus.h"
+
+typedef void (*fnptr)();
+
+enum eIrqIndex {
+  II_VBLANK = 0,
+  II_HBLANK,
+  II_VCOUNT,
+  II_TIMER0,
+  II_TIMER1,
+  II_TIMER2,
+  II_TIMER3,
+  II_SERIAL,
+  II_DMA0,
+  II_DMA1,
+  II_DMA2,
+  II_DMA3,
+  II_KEYPAD,
+  II_GAMEPAK,
+  II_MAX
+};
+
+inline void irq_init(fnptr isr) {
+  linkHostBus->_resetIRQHandlers();
+}
+
+inline fnptr irq_add(eIrqIndex index, fnptr isr) {
+  linkHostBus->_setIRQHandler(index, isr);
+  return nullptr;
+}
+
+inline fnptr irq_delete(eIrqIndex index) {
+  linkHostBus->_setIRQHandler(index, nullptr);
+  return nullptr;
+}
+
+#endif  // LINK_HOST_TONC_IRQ_H